@@ -24,9 +24,12 @@
 #include <stdbool.h>
 #include <unistd.h>
 #include <termios.h>
-#include <fcntl.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
 
 /******************************
  * DÉCLARATION DES CONSTANTES *
@@ -34,17 +37,20 @@
 #define TAILLE 10
 #define LARGEUR_PLATEAU 80
 #define HAUTEUR_PLATEAU 40
+#define TAILLE_MAX (LARGEUR_PLATEAU * HAUTEUR_PLATEAU)
 #define X_INITIAL 40
 #define Y_INITIAL 20
 #define NB_POMMES 10
 #define NB_PAVES 6
 #define ATTENTE 200000
+#define MAX_TOURS_RETARD 5
 #define CORPS 'X'
 #define TETE 'O'
 #define BORDURE '#'
 #define VIDE ' '
 #define POMME '6'
 #define STOP 'a'
+#define OPTION_SANS_AFFICHAGE "--sans-affichage"
 
 // Coordonnées des pavés fixes
 int lesPavesX[NB_PAVES] = {3, 74, 3, 74, 38, 38};
@@ -57,6 +63,19 @@ int lesPommesY[NB_POMMES] = {8, 39, 2, 2, 5, 39, 33, 38, 35, 2};
 // Définition du plateau
 typedef char tPlateau[LARGEUR_PLATEAU + 1][HAUTEUR_PLATEAU + 1];
 
+// Cadence des tours : échéance absolue du tour en cours et nombre de tours en retard
+typedef struct {
+    struct timespec echeance;
+    int nbRetards;
+} tCadence;
+
+// Simulation sans terminal : ni affichage, ni attente, ni clavier
+bool modeSansAffichage = false;
+
+// Réglages du terminal à restaurer en fin de partie
+struct termios terminalInitial;
+bool modeBrutActif = false;
+
 /******************************
  * DÉCLARATION DES PROCÉDURES *
  ******************************/
@@ -65,19 +84,27 @@ void dessinerPlateau(tPlateau plateau); // Afficher le plateau de jeu sur l'écr
 void ajouterPomme(tPlateau plateau, int indexPomme); // Ajouter une pomme au plateau de jeu
 void afficher(int x, int y, char c); // Afficher le caractère c à la position (x, y)
 void effacer(int x, int y); // Afficher un espace à la position (x, y)
-void dessinerSerpent(int lesX[], int lesY[], int taille); // Afficher le serpent à l’écran
-void progresser(int lesX[], int lesY[], int *taille, char *direction, tPlateau plateau, bool *collision, bool *pomme, int pommeX, int pommeY); // Calcule et affiche la prochaine position du serpent
+void dessinerSerpent(int lesX[], int lesY[], int indiceTete, int taille); // Afficher le serpent à l’écran
+void progresser(int lesX[], int lesY[], int *indiceTete, int *taille, char *direction, tPlateau plateau, bool *collision, bool *pomme, int pommeX, int pommeY); // Calcule et affiche la prochaine position du serpent
 char calculerDirection(int serpentX, int serpentY, int pommeX, int pommeY, char directionPrecedente, tPlateau plateau); // Calcule la prochaine direction
 void gotoxy(int x, int y); // Positionner le curseur à un endroit précis
-int kbhit(); // Vérifier si une touche a été pressée
+void activerModeBrut(); // Passer le terminal en mode brut jusqu'à la fin du programme
+void restaurerTerminal(); // Rendre au terminal ses réglages d'origine
+void interrompreProgramme(int numeroSignal); // Restaurer le terminal avant de terminer sur un signal
+bool lireTouche(char *touche); // Lire une touche sans attendre
+void demarrerCadence(tCadence *cadence); // Fixer la première échéance à l'instant présent
+bool attendreTourSuivant(tCadence *cadence); // Attendre l'échéance absolue du tour suivant
+long dureeNanosecondes(struct timespec debut, struct timespec fin); // Durée entre deux instants
 
 /***********************
  * FONCTION PRINCIPALE *
  ***********************/
-int main() {
+int main(int argc, char *argv[]) {
     tPlateau plateau;
-    int lesX[LARGEUR_PLATEAU * HAUTEUR_PLATEAU];
-    int lesY[LARGEUR_PLATEAU * HAUTEUR_PLATEAU];
+    // Corps du serpent en tableau circulaire : l'anneau i est à l'indice (indiceTete + i) % TAILLE_MAX
+    int lesX[TAILLE_MAX];
+    int lesY[TAILLE_MAX];
+    int indiceTete = 0;
     char direction = 'd';
     bool collision = false;
     bool pommeMangee = false;
@@ -85,6 +112,19 @@ int main() {
     int nbPommesMangees = 0;
     int cpt = 0;
     char touche;
+    tCadence cadence;
+
+    // Lancement avec --sans-affichage : seules les statistiques de fin sont affichées
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], OPTION_SANS_AFFICHAGE) == 0) {
+            modeSansAffichage = true;
+        }
+    }
+
+    // Le terminal passe une seule fois en mode brut pour toute la partie
+    if (!modeSansAffichage) {
+        activerModeBrut();
+    }
 
     clock_t begin = clock();
 
@@ -97,21 +137,20 @@ int main() {
 
     // Initialisation du plateau
     initPlateau(plateau);
-    system("clear");
+    if (!modeSansAffichage) {
+        system("clear");
+    }
     dessinerPlateau(plateau);
     ajouterPomme(plateau, nbPommesMangees);
-    srand(time(NULL));
     
 
+    demarrerCadence(&cadence);
    while (!collision & nbPommesMangees < NB_POMMES) {
-        if (kbhit()) {
-            touche = getchar();
-            if (touche == STOP) {
-                break;
-            }
+        if (!modeSansAffichage && lireTouche(&touche) && touche == STOP) {
+            break;
         }
 
-        progresser(lesX, lesY, &tailleSerpent, &direction, plateau, &collision, &pommeMangee, lesPommesX[nbPommesMangees], lesPommesY[nbPommesMangees]);
+        progresser(lesX, lesY, &indiceTete, &tailleSerpent, &direction, plateau, &collision, &pommeMangee, lesPommesX[nbPommesMangees], lesPommesY[nbPommesMangees]);
 
         cpt++;
 
@@ -121,9 +160,13 @@ int main() {
                 ajouterPomme(plateau, nbPommesMangees);
             }
         }
-        usleep(ATTENTE);
+        if (!modeSansAffichage) {
+            attendreTourSuivant(&cadence);
+        }
+    }
+    if (!modeSansAffichage) {
+        gotoxy(1, HAUTEUR_PLATEAU + 2);
     }
-    gotoxy(1, HAUTEUR_PLATEAU + 2);
 
     printf("Nombre de déplacements : %d caractères.\n", cpt);
 
@@ -131,6 +174,9 @@ int main() {
     double tmpsCPU = ((end - begin) * 1.0) / CLOCKS_PER_SEC;
     printf("Temps CPU = %.2f secondes.\n", tmpsCPU);
     printf("Partie terminée. Pommes mangées : %d\n", nbPommesMangees);
+    if (!modeSansAffichage) {
+        printf("Tours en retard : %d\n", cadence.nbRetards);
+    }
     return 0;
 }
 
@@ -166,6 +212,9 @@ void initPlateau(tPlateau plateau) {
 }
 
 void dessinerPlateau(tPlateau plateau) {
+    if (modeSansAffichage) {
+        return;
+    }
     for (int j = 1; j <= HAUTEUR_PLATEAU; j++) {
         for (int i = 1; i <= LARGEUR_PLATEAU; i++) {
             afficher(i, j, plateau[i][j]);
@@ -181,38 +230,47 @@ void ajouterPomme(tPlateau plateau, int indexPomme) {
 }
 
 void afficher(int x, int y, char c) {
+    if (modeSansAffichage) {
+        return;
+    }
     gotoxy(x, y);
     printf("%c", c);
     gotoxy(1, 1);
 }
 
 void effacer(int x, int y) {
+    if (modeSansAffichage) {
+        return;
+    }
     gotoxy(x, y);
     printf(" ");
     gotoxy(1, 1);
 }
 
-void dessinerSerpent(int lesX[], int lesY[], int taille) {
+void dessinerSerpent(int lesX[], int lesY[], int indiceTete, int taille) {
     for (int i = 1; i < taille; i++) {
-        afficher(lesX[i], lesY[i], CORPS);
+        afficher(lesX[(indiceTete + i) % TAILLE_MAX], lesY[(indiceTete + i) % TAILLE_MAX], CORPS);
     }
-    afficher(lesX[0], lesY[0], TETE);
+    afficher(lesX[indiceTete], lesY[indiceTete], TETE);
 }
 
-void progresser(int lesX[], int lesY[], int *taille, char *direction, tPlateau plateau, bool *collision, bool *pomme, int pommeX, int pommeY) {
-    effacer(lesX[*taille - 1], lesY[*taille - 1]);
+void progresser(int lesX[], int lesY[], int *indiceTete, int *taille, char *direction, tPlateau plateau, bool *collision, bool *pomme, int pommeX, int pommeY) {
+    int tete = *indiceTete;
+    effacer(lesX[(tete + *taille - 1) % TAILLE_MAX], lesY[(tete + *taille - 1) % TAILLE_MAX]);
 
-    for (int i = *taille - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
-    }
+    // La nouvelle tête prend la case qui précède l'ancienne : le corps ne bouge pas
+    // et la queue sort du serpent d'elle-même (pour grandir, il suffit d'augmenter *taille)
+    tete = (tete + TAILLE_MAX - 1) % TAILLE_MAX;
+    lesX[tete] = lesX[*indiceTete];
+    lesY[tete] = lesY[*indiceTete];
+    *indiceTete = tete;
 
     // Calcul de la direction avant de mettre à jour la position
-    *direction = calculerDirection(lesX[0], lesY[0], pommeX, pommeY, *direction, plateau);
+    *direction = calculerDirection(lesX[tete], lesY[tete], pommeX, pommeY, *direction, plateau);
 
     // Calcul de la prochaine position en fonction de la direction
-    int nextX = lesX[0];
-    int nextY = lesY[0];
+    int nextX = lesX[tete];
+    int nextY = lesY[tete];
     switch (*direction) {
         case 'z': nextY--; break;
         case 's': nextY++; break;
@@ -225,15 +283,15 @@ void progresser(int lesX[], int lesY[], int *taille, char *direction, tPlateau p
         // Essayer de trouver une nouvelle direction en vérifiant toutes les directions possibles
         char newDirection = *direction;
         if (*direction == 'z' || *direction == 's') {
-            if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && plateau[lesX[0] - 1][lesY[0]] != CORPS) {
+            if (plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && plateau[lesX[tete] - 1][lesY[tete]] != CORPS) {
                 newDirection = 'q';
-            } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && plateau[lesX[0] + 1][lesY[0]] != CORPS) {
+            } else if (plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && plateau[lesX[tete] + 1][lesY[tete]] != CORPS) {
                 newDirection = 'd';
             }
         } else if (*direction == 'q' || *direction == 'd') {
-            if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && plateau[lesX[0]][lesY[0] - 1] != CORPS) {
+            if (plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && plateau[lesX[tete]][lesY[tete] - 1] != CORPS) {
                 newDirection = 'z';
-            } else if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && plateau[lesX[0]][lesY[0] + 1] != CORPS) {
+            } else if (plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && plateau[lesX[tete]][lesY[tete] + 1] != CORPS) {
                 newDirection = 's';
             }
         }
@@ -242,8 +300,8 @@ void progresser(int lesX[], int lesY[], int *taille, char *direction, tPlateau p
         *direction = newDirection;
 
         // Recalcul de la prochaine position en fonction de la nouvelle direction
-        nextX = lesX[0];
-        nextY = lesY[0];
+        nextX = lesX[tete];
+        nextY = lesY[tete];
         switch (*direction) {
             case 'z': nextY--; break;
             case 's': nextY++; break;
@@ -253,42 +311,42 @@ void progresser(int lesX[], int lesY[], int *taille, char *direction, tPlateau p
     }
 
     // Mise à jour des coordonnées de la tête du serpent
-    lesX[0] = nextX;
-    lesY[0] = nextY;
+    lesX[tete] = nextX;
+    lesY[tete] = nextY;
 
     // Vérifier la proximité d'un portail et diriger le serpent vers celui-ci
-    if (lesX[0] == LARGEUR_PLATEAU / 2 && lesY[0] == 0) { // Portail haut
-        lesY[0] = HAUTEUR_PLATEAU;
-    } else if (lesX[0] == LARGEUR_PLATEAU / 2 && lesY[0] == HAUTEUR_PLATEAU + 1) { // Portail bas
-        lesY[0] = 0;
-    } else if (lesY[0] == HAUTEUR_PLATEAU / 2 && lesX[0] == 0) { // Portail gauche
-        lesX[0] = LARGEUR_PLATEAU;
-    } else if (lesY[0] == HAUTEUR_PLATEAU / 2 && lesX[0] == LARGEUR_PLATEAU + 1) { // Portail droit
-        lesX[0] = 0;
+    if (lesX[tete] == LARGEUR_PLATEAU / 2 && lesY[tete] == 0) { // Portail haut
+        lesY[tete] = HAUTEUR_PLATEAU;
+    } else if (lesX[tete] == LARGEUR_PLATEAU / 2 && lesY[tete] == HAUTEUR_PLATEAU + 1) { // Portail bas
+        lesY[tete] = 0;
+    } else if (lesY[tete] == HAUTEUR_PLATEAU / 2 && lesX[tete] == 0) { // Portail gauche
+        lesX[tete] = LARGEUR_PLATEAU;
+    } else if (lesY[tete] == HAUTEUR_PLATEAU / 2 && lesX[tete] == LARGEUR_PLATEAU + 1) { // Portail droit
+        lesX[tete] = 0;
     }
 
     // Gestion des trous (passages à travers les bords)
-    if (lesX[0] <= 0) {
-        lesX[0] = LARGEUR_PLATEAU;
+    if (lesX[tete] <= 0) {
+        lesX[tete] = LARGEUR_PLATEAU;
     } 
-    if (lesX[0] > LARGEUR_PLATEAU) {
-        lesX[0] = 1;
+    if (lesX[tete] > LARGEUR_PLATEAU) {
+        lesX[tete] = 1;
     } 
-    if (lesY[0] <= 0) {
-        lesY[0] = HAUTEUR_PLATEAU;
+    if (lesY[tete] <= 0) {
+        lesY[tete] = HAUTEUR_PLATEAU;
     } 
-    if (lesY[0] > HAUTEUR_PLATEAU) {
-        lesY[0] = 1;
+    if (lesY[tete] > HAUTEUR_PLATEAU) {
+        lesY[tete] = 1;
     }
 
-    *collision = (plateau[lesX[0]][lesY[0]] == BORDURE || plateau[lesX[0]][lesY[0]] == CORPS);
-    *pomme = (plateau[lesX[0]][lesY[0]] == POMME);
+    *collision = (plateau[lesX[tete]][lesY[tete]] == BORDURE || plateau[lesX[tete]][lesY[tete]] == CORPS);
+    *pomme = (plateau[lesX[tete]][lesY[tete]] == POMME);
 
     if (*pomme) {
-        plateau[lesX[0]][lesY[0]] = VIDE;
+        plateau[lesX[tete]][lesY[tete]] = VIDE;
     }
 
-    dessinerSerpent(lesX, lesY, *taille);
+    dessinerSerpent(lesX, lesY, tete, *taille);
 }
 
 char calculerDirection(int serpentX, int serpentY, int pommeX, int pommeY, char directionPrecedente, tPlateau plateau) {
@@ -335,22 +393,75 @@ void gotoxy(int x, int y) {
     printf("\033[%d;%dH", y, x);
 }
 
-int kbhit() {
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-    ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-    if (ch != EOF) {
-        ungetc(ch, stdin);
-        return 1;
+void activerModeBrut() {
+    struct termios terminalBrut;
+
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &terminalInitial) != 0) {
+        return;
     }
-    return 0;
-}
\ No newline at end of file
+    terminalBrut = terminalInitial;
+    terminalBrut.c_lflag &= ~(ICANON | ECHO);
+    terminalBrut.c_cc[VMIN] = 0;
+    terminalBrut.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalBrut) != 0) {
+        return;
+    }
+    modeBrutActif = true;
+
+    atexit(restaurerTerminal);
+    signal(SIGINT, interrompreProgramme);
+    signal(SIGTERM, interrompreProgramme);
+    signal(SIGHUP, interrompreProgramme);
+    signal(SIGQUIT, interrompreProgramme);
+}
+
+void restaurerTerminal() {
+    if (modeBrutActif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial);
+        modeBrutActif = false;
+    }
+}
+
+void interrompreProgramme(int numeroSignal) {
+    restaurerTerminal();
+    signal(numeroSignal, SIG_DFL);
+    raise(numeroSignal);
+}
+
+bool lireTouche(char *touche) {
+    struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+    return poll(&entree, 1, 0) > 0 && read(STDIN_FILENO, touche, 1) == 1;
+}
+
+void demarrerCadence(tCadence *cadence) {
+    clock_gettime(CLOCK_MONOTONIC, &cadence->echeance);
+    cadence->nbRetards = 0;
+}
+
+bool attendreTourSuivant(tCadence *cadence) {
+    struct timespec maintenant;
+    long retard;
+
+    cadence->echeance.tv_nsec += ATTENTE * 1000L;
+    cadence->echeance.tv_sec += cadence->echeance.tv_nsec / 1000000000L;
+    cadence->echeance.tv_nsec %= 1000000000L;
+
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    retard = dureeNanosecondes(cadence->echeance, maintenant);
+    if (retard <= 0) {
+        // L'attente reprend jusqu'à la même échéance si un signal l'interrompt
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &cadence->echeance, NULL) == EINTR) {
+        }
+        return false;
+    }
+
+    cadence->nbRetards++;
+    if (retard > MAX_TOURS_RETARD * ATTENTE * 1000L) {
+        cadence->echeance = maintenant;
+    }
+    return true;
+}
+
+long dureeNanosecondes(struct timespec debut, struct timespec fin) {
+    return (fin.tv_sec - debut.tv_sec) * 1000000000L + (fin.tv_nsec - debut.tv_nsec);
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Compile les variantes v3, version3-12, version4-1 et version4-5 puis lance
+# leur benchmark sans affichage avec les mêmes options.
+#
+# Usage : ./benchmark.sh [--parties=N] [--graine=G] [--disposition=fixe|aleatoire] [resultats.csv]
+#
+# Le bilan de chaque variante est affiché en clair ; le détail par partie est
+# ajouté au fichier CSV (benchmark.csv par défaut).
+
+set -e
+
+CSV=benchmark.csv
+OPTIONS=""
+for argument in "$@"; do
+    case "$argument" in
+        --*) OPTIONS="$OPTIONS $argument" ;;
+        *) CSV="$argument" ;;
+    esac
+done
+
+REPERTOIRE=$(dirname "$0")
+BINAIRES=$(mktemp -d)
+trap 'rm -rf "$BINAIRES"' EXIT
+
+for variante in v3 version3-12_102 version4-1_102 version4-5_102; do
+    ${CC:-gcc} -O2 -pthread -o "$BINAIRES/$variante" "$REPERTOIRE/$variante.c" -lm
+    "$BINAIRES/$variante" --benchmark $OPTIONS --csv="$CSV"
+    echo
+done
@@ -4,8 +4,12 @@
 #include <unistd.h>
 #include <time.h>
 #include <termios.h>
-#include <fcntl.h>
 #include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
 
 /******************************
 *  Constantes                *
@@ -15,7 +19,8 @@
 #define HAUTEUR_PLATEAU 40     ///< Hauteur du plateau
 #define TAILLE 10              ///< Taille fixe du serpent
 #define NB_POMMES 10           ///< Nombre total de pommes à  manger
-#define ATTENTE 200000          ///< Temporisation entre deux déplacements (en microsecondes)
+#define ATTENTE 200000          ///< Période d'un tour (en microsecondes)
+#define MAX_TOURS_RETARD 5     ///< Retard (en tours) au-delà duquel la cadence repart de l'instant présent
 #define CORPS 'X'              ///< Représentation des anneaux du serpent
 #define TETE 'O'               ///< Représentation de la tête du serpent
 #define BORDURE '#'            ///< Représentation des bordures du plateau
@@ -26,20 +31,85 @@
 #define VIDE ' '               ///< Représentation des espaces vides
 #define POMME '6'              ///< Représentation d'une pomme
 #define STOP 'a'               ///< Touche pour arrêter le jeu
+#define OPTION_SANS_AFFICHAGE "--sans-affichage" ///< Option de lancement sans affichage ni temporisation
+#define OPTION_BENCHMARK "--benchmark"     ///< Option de lancement d'une série de parties chronométrées
+#define OPTION_PARTIES "--parties="        ///< Option du nombre de parties du benchmark
+#define OPTION_GRAINE "--graine="          ///< Option de la graine de la première partie du benchmark
+#define OPTION_DISPOSITION "--disposition=" ///< Option de la disposition des pommes (fixe ou aleatoire)
+#define OPTION_CSV "--csv="                ///< Option du fichier CSV où ajouter les résultats du benchmark
+#define DISPOSITION_ALEATOIRE "aleatoire"  ///< Pommes tirées au hasard à partir de la graine de chaque partie
+#define NB_PARTIES_DEFAUT 100              ///< Nombre de parties du benchmark par défaut
+#define MAX_DEPLACEMENTS 20000             ///< Nombre de tours au-delà duquel une partie du benchmark est abandonnée
+#define NOM_VARIANTE "v3"               ///< Nom de la variante dans les résultats du benchmark
 
 typedef char tPlateau[LARGEUR_PLATEAU + 1][HAUTEUR_PLATEAU + 1];
 
+/**
+ * Bilan d'une partie.
+ */
+typedef struct {
+    int nbDeplacements;  ///< Nombre de tours joués
+    int nbPommesMangees; ///< Nombre de pommes mangées
+    bool abandonnee;     ///< Vrai si la partie a été arrêtée au bout de MAX_DEPLACEMENTS tours
+    int nbRetards;       ///< Nombre de tours terminés après leur échéance
+} tPartie;
+
+/**
+ * Durées de décision relevées à chaque tour pendant un benchmark.
+ */
+typedef struct {
+    long *lesDurees; ///< Durées en nanosecondes, dans l'ordre des tours
+    int nbDurees;    ///< Nombre de durées relevées
+    int capacite;    ///< Nombre de durées que peut contenir lesDurees
+} tLatences;
+
+/**
+ * Cadence des tours de jeu.
+ */
+typedef struct {
+    struct timespec echeance; ///< Date absolue (CLOCK_MONOTONIC) de la fin du tour en cours
+    int nbRetards;            ///< Nombre de tours terminés après leur échéance
+} tCadence;
+
+/**
+ * Générateur pseudo-aléatoire xoshiro256** propre à un tirage. Sa suite ne
+ * dépend que de la graine, pas de la bibliothèque C (contrairement à
+ * rand_r()) : une graine donne la même partie sur toutes les machines.
+ */
+typedef struct {
+    uint64_t etat[4]; ///< État du générateur, jamais entièrement nul
+} tAleatoire;
+
+bool modeSansAffichage = false; ///< Vrai si la partie est simulée sans terminal (ni affichage, ni attente, ni clavier)
+struct termios terminalInitial;  ///< Réglages du terminal à restaurer en fin de partie
+bool modeBrutActif = false;      ///< Vrai tant que le terminal est en mode brut
+
 // Prototypes des fonctions
 void initPlateau(tPlateau plateau);
 void dessinerPlateau(tPlateau plateau);
 void afficher(int x, int y, char car);
 void effacer(int x, int y);
-void dessinerSerpent(int lesX[], int lesY[]);
-bool collision(int x, int y, int lesX[], int lesY[]);
-void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau, bool *pomme);
+void dessinerSerpent(int lesX[], int lesY[], int indiceTete);
+bool collision(int x, int y, int lesX[], int lesY[], int indiceTete);
+void progresser(int lesX[], int lesY[], int *indiceTete, int cibleX, int cibleY, tPlateau plateau, bool *pomme);
 void gotoxy(int x, int y);
 void finProgramme(int nbDeplacements, clock_t tempsDebut, clock_t tempsFin);
-int kbhit();
+tPartie jouerPartie(int lesPommesX[], int lesPommesY[], int maxDeplacements, tLatences *latences);
+void lancerBenchmark(int nbParties, unsigned int graine, bool aleatoire, int lesPommesX[], int lesPommesY[], const char *fichierCsv);
+void initialiserAleatoire(tAleatoire *aleatoire, uint64_t graine);
+uint64_t tirerAleatoire(tAleatoire *aleatoire);
+int tirerEntier(tAleatoire *aleatoire, int borne);
+void genererPommes(unsigned int graine, int lesPommesX[], int lesPommesY[]);
+void enregistrerLatence(tLatences *latences, long duree);
+long dureeNanosecondes(struct timespec debut, struct timespec fin);
+int comparerDurees(const void *a, const void *b);
+void calculerPercentiles(long lesDurees[], int nbDurees, long *p50, long *p99, long *max);
+void activerModeBrut();
+void restaurerTerminal();
+void interrompreProgramme(int numeroSignal);
+bool lireTouche(char *touche);
+void demarrerCadence(tCadence *cadence);
+bool attendreTourSuivant(tCadence *cadence);
 void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY, int *nouvelleX, int *nouvelleY, bool *utilisePortail);
 
 /**************************************
@@ -51,22 +121,89 @@ void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY
 /**
  * @brief Programme principal du jeu.
  *
- * Cette fonction gare le jeu, le plateau, le serpent, les pommes, et le mouvement du serpent.
- * Elle gare également l'affichage du nombre de déplacements et du temps d'exécution du jeu.
+ * Cette fonction lit les options de lancement puis joue une partie avec les
+ * pommes prévues. Elle gare également l'affichage du nombre de déplacements et du temps d'exécution du jeu.
+ *
+ * Lancé avec l'option --sans-affichage, le jeu est simulé sans affichage ni
+ * temporisation et seules les statistiques de fin sont affichées.
+ *
+ * Lancé avec l'option --benchmark, le programme enchaîne sans affichage
+ * plusieurs parties et affiche leurs statistiques (voir lancerBenchmark()).
+ * Les options --parties=N, --graine=G, --disposition=fixe|aleatoire et
+ * --csv=fichier règlent la série.
  *
+ * @param argc Nombre d'arguments de la ligne de commande.
+ * @param argv Arguments de la ligne de commande.
  * @return EXIT_SUCCESS si le programme s'est exécuté avec succas.
  */
-int main() {
-    tPlateau lePlateau;
-    int lesX[TAILLE], lesY[TAILLE];
+int main(int argc, char *argv[]) {
     int lesPommesX[NB_POMMES] = {75, 75, 78, 2, 8, 78, 74, 2, 72, 5};
     int lesPommesY[NB_POMMES] = {8, 39, 2, 2, 5, 39, 33, 38, 35, 2};
-    int nbDeplacements = 0;
+    bool modeBenchmark = false;
+    int nbParties = NB_PARTIES_DEFAUT;
+    unsigned int graine = 1;
+    bool aleatoire = false;
+    const char *fichierCsv = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], OPTION_SANS_AFFICHAGE) == 0) {
+            modeSansAffichage = true;
+        } else if (strcmp(argv[i], OPTION_BENCHMARK) == 0) {
+            modeBenchmark = true;
+        } else if (strncmp(argv[i], OPTION_PARTIES, strlen(OPTION_PARTIES)) == 0) {
+            nbParties = atoi(argv[i] + strlen(OPTION_PARTIES));
+        } else if (strncmp(argv[i], OPTION_GRAINE, strlen(OPTION_GRAINE)) == 0) {
+            graine = (unsigned int)strtoul(argv[i] + strlen(OPTION_GRAINE), NULL, 10);
+        } else if (strncmp(argv[i], OPTION_DISPOSITION, strlen(OPTION_DISPOSITION)) == 0) {
+            aleatoire = strcmp(argv[i] + strlen(OPTION_DISPOSITION), DISPOSITION_ALEATOIRE) == 0;
+        } else if (strncmp(argv[i], OPTION_CSV, strlen(OPTION_CSV)) == 0) {
+            fichierCsv = argv[i] + strlen(OPTION_CSV);
+        }
+    }
+
+    if (modeBenchmark) {
+        lancerBenchmark(nbParties, graine, aleatoire, lesPommesX, lesPommesY, fichierCsv);
+        return EXIT_SUCCESS;
+    }
+
+    // Le terminal passe une seule fois en mode brut pour toute la partie
+    if (!modeSansAffichage) {
+        activerModeBrut();
+    }
+
+    clock_t tempsDebut = clock();
+    tPartie partie = jouerPartie(lesPommesX, lesPommesY, 0, NULL);
+    clock_t tempsFin = clock();
+    finProgramme(partie.nbDeplacements, tempsDebut, tempsFin);
+    if (!modeSansAffichage) {
+        printf("Tours en retard : %d\n", partie.nbRetards);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Joue une partie complète.
+ *
+ * La partie s'arrête quand toutes les pommes sont mangées, quand la touche
+ * STOP est appuyée ou, si maxDeplacements est positif, au bout de
+ * maxDeplacements tours.
+ *
+ * @param lesPommesX Positions X des pommes, dans l'ordre où elles apparaissent.
+ * @param lesPommesY Positions Y des pommes, dans l'ordre où elles apparaissent.
+ * @param maxDeplacements Nombre maximal de tours (0 : pas de limite).
+ * @param latences Si non NULL, reçoit la durée de décision de chaque tour.
+ * @return Le bilan de la partie.
+ */
+tPartie jouerPartie(int lesPommesX[], int lesPommesY[], int maxDeplacements, tLatences *latences) {
+    tPlateau lePlateau;
+    int lesX[TAILLE], lesY[TAILLE];
+    int indiceTete = 0;
+    tPartie partie = {0, 0, false, 0};
     int indexPomme = 0;
     bool pommeMangee = false;
     char touche;
-
-    clock_t tempsDebut = clock();
+    struct timespec debutDecision, finDecision;
+    tCadence cadence;
 
     for (int i = 0; i < TAILLE; i++) {
         lesX[i] = 40 - i;
@@ -76,19 +213,30 @@ int main() {
     initPlateau(lePlateau);
     dessinerPlateau(lePlateau);
     afficher(lesPommesX[indexPomme], lesPommesY[indexPomme], POMME);
-    dessinerSerpent(lesX, lesY);
+    dessinerSerpent(lesX, lesY, indiceTete);
 
+    demarrerCadence(&cadence);
     while (indexPomme < NB_POMMES) {
-        if (kbhit()) {
-            touche = getchar();
-            if (touche == STOP) {
-                break;
-            }
+        if (maxDeplacements > 0 && partie.nbDeplacements >= maxDeplacements) {
+            partie.abandonnee = true;
+            break;
+        }
+        if (!modeSansAffichage && lireTouche(&touche) && touche == STOP) {
+            break;
         }
 
-        progresser(lesX, lesY, lesPommesX[indexPomme], lesPommesY[indexPomme], lePlateau, &pommeMangee);
-        nbDeplacements++;
-        usleep(ATTENTE);
+        if (latences != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &debutDecision);
+        }
+        progresser(lesX, lesY, &indiceTete, lesPommesX[indexPomme], lesPommesY[indexPomme], lePlateau, &pommeMangee);
+        if (latences != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &finDecision);
+            enregistrerLatence(latences, dureeNanosecondes(debutDecision, finDecision));
+        }
+        partie.nbDeplacements++;
+        if (!modeSansAffichage) {
+            attendreTourSuivant(&cadence);
+        }
 
         if (pommeMangee) {
             indexPomme++;
@@ -99,9 +247,9 @@ int main() {
         }
     }
 
-    clock_t tempsFin = clock();
-    finProgramme(nbDeplacements, tempsDebut, tempsFin);
-    return EXIT_SUCCESS;
+    partie.nbPommesMangees = indexPomme;
+    partie.nbRetards = cadence.nbRetards;
+    return partie;
 }
 
 /**********************************
@@ -220,11 +368,11 @@ void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY
 }
 
 
-// Fonction pour vérifier les collisions avec le corps du serpent
-bool collision(int x, int y, int lesX[], int lesY[]) {
+// Fonction pour vérifier les collisions avec le corps du serpent (toutes les cases sauf la tête)
+bool collision(int x, int y, int lesX[], int lesY[], int indiceTete) {
     bool res = false;
-    for (int i = 1; i < TAILLE; i++) {
-        if (lesX[i] == x && lesY[i] == y) {
+    for (int i = 0; i < TAILLE; i++) {
+        if (i != indiceTete && lesX[i] == x && lesY[i] == y) {
             res = true; // Il y a une collision
             break; // Sort de la boucle das qu'une collision est détectée
         }
@@ -240,112 +388,116 @@ bool collision(int x, int y, int lesX[], int lesY[]) {
  *
  * @param lesX Tableau des positions X des segments du serpent.
  * @param lesY Tableau des positions Y des segments du serpent.
+ * @param indiceTete Pointeur vers l'indice de la tête dans les tableaux circulaires.
  * @param cibleX Position X de la cible (pomme ou portail).
  * @param cibleY Position Y de la cible (pomme ou portail).
  * @param plateau Le plateau de jeu.
  * @param pomme Pointeur vers une variable booléenne indiquant si la pomme est mangée.
  */
-void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau, bool *pomme) {
+void progresser(int lesX[], int lesY[], int *indiceTete, int cibleX, int cibleY, tPlateau plateau, bool *pomme) {
+    int tete = *indiceTete;
     int prochainX = cibleX, prochainY = cibleY;
     bool utilisePortail = false;
 
     // Déterminer la cible optimale (directe ou via un portail)
-    calculerDistanceOptimale(lesX[0], lesY[0], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
+    calculerDistanceOptimale(lesX[tete], lesY[tete], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
+
+    // La queue occupe la case qui précède la tête dans le tableau circulaire
+    tete = (tete + TAILLE - 1) % TAILLE;
 
     // Efface le dernier segment du serpent
-    effacer(lesX[TAILLE - 1], lesY[TAILLE - 1]);
+    effacer(lesX[tete], lesY[tete]);
 
-    // Déplace les segments du corps
-    for (int i = TAILLE - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
-    }
+    // La case de la queue devient la nouvelle tête : le corps ne bouge pas
+    lesX[tete] = lesX[*indiceTete];
+    lesY[tete] = lesY[*indiceTete];
+    *indiceTete = tete;
     // si un portail est à utiliser utilisePortail=true
     if (utilisePortail) {
         // se déplace en choisissant le chemin optimal à utiliser ici il est plus optimiser d'aller vers le haut cela réduit le nombre de déplacement
         bool endroitBloque=true;
-        if (lesY[0] < prochainY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY)) {
-            lesY[0]++;
+        if (lesY[tete] < prochainY && plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete)) {
+            lesY[tete]++;
             endroitBloque=false;
-        } else if (lesY[0] > prochainY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY)) {
-            lesY[0]--;
+        } else if (lesY[tete] > prochainY && plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete)) {
+            lesY[tete]--;
             endroitBloque=false;
-        } else if (lesX[0] < prochainX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY)) {
-            lesX[0]++;
+        } else if (lesX[tete] < prochainX && plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete)) {
+            lesX[tete]++;
             endroitBloque=false ;
-        } else if (lesX[0] > prochainX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY)) {
-            lesX[0]--;
+        } else if (lesX[tete] > prochainX && plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete)) {
+            lesX[tete]--;
             endroitBloque=false;
         }
         //si le chemin optimal est bloqué par les bord, le corp du serpent et la position du serpent par rapport à la cible 
         //on recherche le chemin optimal pour sortir le plus facilement avec les contraintes des bordures et du corps du serpent
         if (endroitBloque){
-            if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY)) {
-                lesX[0]++;
-            } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY)) {
-                lesX[0]--;
-            } else if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY)) {
-                lesY[0]++;
-            } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY)) {
-                lesY[0]--;
+            if (plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete)) {
+                lesX[tete]++;
+            } else if (plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete)) {
+                lesX[tete]--;
+            } else if (plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete)) {
+                lesY[tete]++;
+            } else if (plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete)) {
+                lesY[tete]--;
             }
         }
         // Vérifier si le serpent a atteint le portail
-        if (lesX[0] == prochainX && lesY[0] == prochainY) {
+        if (lesX[tete] == prochainX && lesY[tete] == prochainY) {
             // Recalculer la cible après avoir traversé le portail 
             // les valeurs d'arrivé sont 2 et LARGEUR_PLATEAU-1 puisque le serpent ne doit pas sortir du plateau
             if (prochainY == HAUTEUR_PLATEAU+1) {
-                lesY[0] = 1;
+                lesY[tete] = 1;
             } else if (prochainY == 0) {
-                lesY[0] = HAUTEUR_PLATEAU;
+                lesY[tete] = HAUTEUR_PLATEAU;
             } else if (prochainX == LARGEUR_PLATEAU+1) {
-                lesX[0] = 1;
+                lesX[tete] = 1;
             } else if (prochainX == 0) {
-                lesX[0] = LARGEUR_PLATEAU;
+                lesX[tete] = LARGEUR_PLATEAU;
             } 
             //On redéfini où doit passer le serpent
-            calculerDistanceOptimale(lesX[0], lesY[0], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
+            calculerDistanceOptimale(lesX[tete], lesY[tete], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
         }
     } else {
         // Déplacement optimal vers la cible en évitant les collisions avec le corps du serpent et les bordures
-        if (lesY[0] < cibleY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY) && ((!(plateau[lesX[0]-1][lesY[0]+1]==PAVE && plateau[lesX[0]+1][lesY[0]+1]==PAVE)) || cibleX>lesX[0]-TAILLE_PAVE_X)) {
-            lesY[0]++;
-        } else if (lesY[0] > cibleY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY) && ((!(plateau[lesX[0]-1][lesY[0]-1]==PAVE && plateau[lesX[0]+1][lesY[0]-1]==PAVE)) || cibleX<lesX[0]+TAILLE_PAVE_X)) {
-            lesY[0]--;
-        } else if (lesX[0] < cibleX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY)) {
-            lesX[0]++;
-        } else if (lesX[0] > cibleX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY)) {
-            lesX[0]--;
+        if (lesY[tete] < cibleY && plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete) && ((!(plateau[lesX[tete]-1][lesY[tete]+1]==PAVE && plateau[lesX[tete]+1][lesY[tete]+1]==PAVE)) || cibleX>lesX[tete]-TAILLE_PAVE_X)) {
+            lesY[tete]++;
+        } else if (lesY[tete] > cibleY && plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete) && ((!(plateau[lesX[tete]-1][lesY[tete]-1]==PAVE && plateau[lesX[tete]+1][lesY[tete]-1]==PAVE)) || cibleX<lesX[tete]+TAILLE_PAVE_X)) {
+            lesY[tete]--;
+        } else if (lesX[tete] < cibleX && plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete)) {
+            lesX[tete]++;
+        } else if (lesX[tete] > cibleX && plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete)) {
+            lesX[tete]--;
         } else {
             // Déplacement optimal vers la cible en évitant les collisions avec le corps, les bordures et les pavés
-            if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && cibleY>lesY[0] && !collision(lesX[0], lesY[0] + 1, lesX, lesY) && lesY[0] < TAILLE - 1) {
-                lesY[0]++;
-            } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && cibleY<lesY[0] && !collision(lesX[0], lesY[0] - 1, lesX, lesY) && lesY[0] > 0) {
-                lesY[0]--;
-            } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && cibleX<lesX[0] && !collision(lesX[0] + 1, lesY[0], lesX, lesY) && lesX[0] < TAILLE - 1) {
-                lesX[0]++;
-            } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && cibleX>lesX[0] && !collision(lesX[0] - 1, lesY[0], lesX, lesY) && lesX[0] > 0) {
-                lesX[0]--;
+            if (plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && cibleY>lesY[tete] && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete) && lesY[tete] < TAILLE - 1) {
+                lesY[tete]++;
+            } else if (plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && cibleY<lesY[tete] && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete) && lesY[tete] > 0) {
+                lesY[tete]--;
+            } else if (plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && cibleX<lesX[tete] && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete) && lesX[tete] < TAILLE - 1) {
+                lesX[tete]++;
+            } else if (plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && cibleX>lesX[tete] && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete) && lesX[tete] > 0) {
+                lesX[tete]--;
             } else {
                 //Déplacement vers la cible en évitant les collisions le corps, les bordures et les pavés
-                if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY) && lesY[0] < TAILLE-1) {
-                    lesY[0]++;
-                } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY) && lesY[0] > 0) {
-                    lesY[0]--;
-                } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY) && lesX[0] < TAILLE-1) {
-                    lesX[0]++;
-                } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY) && lesX[0] > 0) {
-                    lesX[0]--;
+                if (plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete) && lesY[tete] < TAILLE-1) {
+                    lesY[tete]++;
+                } else if (plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete) && lesY[tete] > 0) {
+                    lesY[tete]--;
+                } else if (plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete) && lesX[tete] < TAILLE-1) {
+                    lesX[tete]++;
+                } else if (plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete) && lesX[tete] > 0) {
+                    lesX[tete]--;
                 } else {
                     // Si aucune direction n'était possible, se déplace aléatoirement en évitant le corps et les bordures
-                    if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY)) {
-                        lesY[0]++;
-                    } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY)) {
-                        lesY[0]--;
-                    } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY)) {
-                        lesX[0]++;
-                    } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY)) {
-                        lesX[0]--;
+                    if (plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete)) {
+                        lesY[tete]++;
+                    } else if (plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete)) {
+                        lesY[tete]--;
+                    } else if (plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete)) {
+                        lesX[tete]++;
+                    } else if (plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete)) {
+                        lesX[tete]--;
                     }
                 }
             }
@@ -353,10 +505,10 @@ void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau
     }
 
     // Vérifie si la tête du serpent atteint la pomme
-    *pomme = (lesX[0] == cibleX && lesY[0] == cibleY);
+    *pomme = (lesX[tete] == cibleX && lesY[tete] == cibleY);
 
     // Redessine le serpent
-    dessinerSerpent(lesX, lesY);
+    dessinerSerpent(lesX, lesY, tete);
 }
 
 
@@ -369,6 +521,9 @@ void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau
  * @param plateau Le plateau de jeu.
  */
 void dessinerPlateau(tPlateau plateau) {
+    if (modeSansAffichage) {
+        return;
+    }
     for (int i = 1; i <= LARGEUR_PLATEAU; i++) {
         for (int j = 1; j <= HAUTEUR_PLATEAU; j++) {
             afficher(i, j, plateau[i][j]);
@@ -386,6 +541,9 @@ void dessinerPlateau(tPlateau plateau) {
  * @param car Caractare à  afficher.
  */
 void afficher(int x, int y, char car) {
+    if (modeSansAffichage) {
+        return;
+    }
     gotoxy(x, y);
     printf("%c", car);
     fflush(stdout);
@@ -411,11 +569,12 @@ void effacer(int x, int y) {
  *
  * @param lesX Tableau des positions X des segments du serpent.
  * @param lesY Tableau des positions Y des segments du serpent.
+ * @param indiceTete Indice de la tête dans les tableaux circulaires.
  */
-void dessinerSerpent(int lesX[], int lesY[]) {
-    afficher(lesX[0], lesY[0], TETE);
+void dessinerSerpent(int lesX[], int lesY[], int indiceTete) {
+    afficher(lesX[indiceTete], lesY[indiceTete], TETE);
     for (int i = 1; i < TAILLE; i++) {
-        afficher(lesX[i], lesY[i], CORPS);
+        afficher(lesX[(indiceTete + i) % TAILLE], lesY[(indiceTete + i) % TAILLE], CORPS);
     }
 }
 
@@ -450,28 +609,361 @@ void finProgramme(int nbDeplacements, clock_t tempsDebut, clock_t tempsFin) {
 }
 
 /**
- * @brief Vérifie si une touche a été appuyée.
+ * @brief Enchaîne des parties sans affichage et affiche leurs statistiques.
+ *
+ * La partie i utilise la graine graine + i. Avec la disposition fixe, toutes
+ * les parties reprennent les pommes prévues et ne mesurent que la vitesse du
+ * moteur ; avec la disposition aléatoire, les pommes sont tirées à partir de
+ * la graine. Le bilan (déplacements, pommes mangées, tours par seconde et
+ * percentiles de la durée de décision d'un tour) est affiché en clair et,
+ * si fichierCsv est donné, ajouté à ce fichier à raison d'une ligne par
+ * partie et d'une ligne de total.
+ *
+ * @param nbParties Nombre de parties à jouer.
+ * @param graine Graine de la première partie.
+ * @param aleatoire Vrai pour tirer les pommes au hasard.
+ * @param lesPommesX Positions X des pommes prévues.
+ * @param lesPommesY Positions Y des pommes prévues.
+ * @param fichierCsv Fichier CSV à compléter, ou NULL.
+ */
+void lancerBenchmark(int nbParties, unsigned int graine, bool aleatoire, int lesPommesX[], int lesPommesY[], const char *fichierCsv) {
+    tLatences latences = {NULL, 0, 0};
+    int partiePommesX[NB_POMMES], partiePommesY[NB_POMMES];
+    long totalDeplacements = 0, totalPommes = 0;
+    int nbAbandons = 0;
+    long p50, p99, max;
+    FILE *csv = NULL;
+    struct timespec debut, fin, debutPartie, finPartie;
+
+    modeSansAffichage = true;
+
+    if (fichierCsv != NULL) {
+        csv = fopen(fichierCsv, "a");
+        if (csv == NULL) {
+            perror(fichierCsv);
+            exit(EXIT_FAILURE);
+        }
+        // L'entête n'est écrite que dans un fichier neuf, pour cumuler plusieurs variantes
+        if (ftell(csv) == 0) {
+            fprintf(csv, "variante,partie,graine,disposition,deplacements,pommes,abandon,tours_par_seconde,latence_p50_ns,latence_p99_ns,latence_max_ns\n");
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nbParties; i++) {
+        if (aleatoire) {
+            genererPommes(graine + i, partiePommesX, partiePommesY);
+        } else {
+            memcpy(partiePommesX, lesPommesX, sizeof(partiePommesX));
+            memcpy(partiePommesY, lesPommesY, sizeof(partiePommesY));
+        }
+
+        int premiereDuree = latences.nbDurees;
+        clock_gettime(CLOCK_MONOTONIC, &debutPartie);
+        tPartie partie = jouerPartie(partiePommesX, partiePommesY, MAX_DEPLACEMENTS, &latences);
+        clock_gettime(CLOCK_MONOTONIC, &finPartie);
+
+        totalDeplacements += partie.nbDeplacements;
+        totalPommes += partie.nbPommesMangees;
+        if (partie.abandonnee) {
+            nbAbandons++;
+        }
+
+        if (csv != NULL) {
+            // Les durées de la partie sont triées sur place : le tri global final n'en dépend pas
+            calculerPercentiles(latences.lesDurees + premiereDuree, latences.nbDurees - premiereDuree, &p50, &p99, &max);
+            double secondes = dureeNanosecondes(debutPartie, finPartie) / 1e9;
+            fprintf(csv, "%s,%d,%u,%s,%d,%d,%d,%.0f,%ld,%ld,%ld\n", NOM_VARIANTE, i, graine + i,
+                    aleatoire ? "aleatoire" : "fixe", partie.nbDeplacements, partie.nbPommesMangees,
+                    partie.abandonnee ? 1 : 0, secondes > 0 ? partie.nbDeplacements / secondes : 0.0, p50, p99, max);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    double secondes = dureeNanosecondes(debut, fin) / 1e9;
+    double toursParSeconde = secondes > 0 ? totalDeplacements / secondes : 0.0;
+    calculerPercentiles(latences.lesDurees, latences.nbDurees, &p50, &p99, &max);
+
+    printf("Benchmark %s : %d parties, graine %u, disposition %s\n", NOM_VARIANTE, nbParties, graine,
+           aleatoire ? "aleatoire" : "fixe");
+    printf("Nombre de déplacements : %ld\n", totalDeplacements);
+    printf("Pommes mangées : %ld / %ld\n", totalPommes, (long)nbParties * NB_POMMES);
+    printf("Parties abandonnées : %d\n", nbAbandons);
+    printf("Tours par seconde : %.0f\n", toursParSeconde);
+    printf("Latence de décision (ns) : p50 %ld, p99 %ld, max %ld\n", p50, p99, max);
+
+    if (csv != NULL) {
+        fprintf(csv, "%s,total,%u,%s,%ld,%ld,%d,%.0f,%ld,%ld,%ld\n", NOM_VARIANTE, graine,
+                aleatoire ? "aleatoire" : "fixe", totalDeplacements, totalPommes, nbAbandons,
+                toursParSeconde, p50, p99, max);
+        fclose(csv);
+    }
+    free(latences.lesDurees);
+}
+
+/**
+ * @brief Initialise un générateur pseudo-aléatoire à partir d'une graine.
+ *
+ * Les quatre mots d'état sont tirés de la graine par splitmix64, qui ne donne
+ * jamais un état entièrement nul.
+ *
+ * @param aleatoire Générateur à initialiser.
+ * @param graine Graine du tirage.
+ */
+void initialiserAleatoire(tAleatoire *aleatoire, uint64_t graine) {
+    for (int i = 0; i < 4; i++) {
+        graine += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = graine;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        aleatoire->etat[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * @brief Tire le nombre pseudo-aléatoire suivant (xoshiro256**).
  *
- * Cette fonction vérifie si une touche a été appuyée sur le clavier.
+ * @param aleatoire Le générateur.
+ * @return Un entier de 64 bits.
+ */
+uint64_t tirerAleatoire(tAleatoire *aleatoire) {
+    uint64_t *etat = aleatoire->etat;
+    uint64_t resultat = etat[1] * 5;
+    resultat = ((resultat << 7) | (resultat >> 57)) * 9;
+    uint64_t decale = etat[1] << 17;
+
+    etat[2] ^= etat[0];
+    etat[3] ^= etat[1];
+    etat[1] ^= etat[2];
+    etat[0] ^= etat[3];
+    etat[2] ^= decale;
+    etat[3] = (etat[3] << 45) | (etat[3] >> 19);
+    return resultat;
+}
+
+/**
+ * @brief Tire un entier uniformément entre 0 et borne - 1.
+ *
+ * Les tirages qui tomberaient dans le reste de la division de 2^64 par borne
+ * sont rejetés, pour que toutes les valeurs soient équiprobables.
+ *
+ * @param aleatoire Le générateur.
+ * @param borne Nombre de valeurs possibles (strictement positif).
+ * @return Un entier de 0 à borne - 1.
+ */
+int tirerEntier(tAleatoire *aleatoire, int borne) {
+    uint64_t limite = UINT64_MAX - UINT64_MAX % (uint64_t)borne;
+    uint64_t tirage;
+    do {
+        tirage = tirerAleatoire(aleatoire);
+    } while (tirage >= limite);
+    return (int)(tirage % (uint64_t)borne);
+}
+
+/**
+ * @brief Tire au hasard les pommes d'une partie.
  *
- * @return 1 si une touche a été appuyée, 0 sinon.
+ * Chaque pomme est placée sur une case vide à l'intérieur des bordures et
+ * diffère de la précédente. Les pavés de ce plateau ne ferment aucun enclos :
+ * toute case vide est accessible. Le tirage ne dépend que de la graine (voir
+ * tAleatoire), ce qui permet de rejouer exactement la même partie.
+ *
+ * @param graine Graine de la partie.
+ * @param lesPommesX Positions X des pommes tirées.
+ * @param lesPommesY Positions Y des pommes tirées.
+ */
+void genererPommes(unsigned int graine, int lesPommesX[], int lesPommesY[]) {
+    tPlateau plateau;
+    tAleatoire aleatoire;
+    initPlateau(plateau);
+    initialiserAleatoire(&aleatoire, graine);
+
+    for (int i = 0; i < NB_POMMES; i++) {
+        int x, y;
+        do {
+            x = 2 + tirerEntier(&aleatoire, LARGEUR_PLATEAU - 2);
+            y = 2 + tirerEntier(&aleatoire, HAUTEUR_PLATEAU - 2);
+        } while (plateau[x][y] != VIDE || (i > 0 && x == lesPommesX[i - 1] && y == lesPommesY[i - 1]));
+        lesPommesX[i] = x;
+        lesPommesY[i] = y;
+    }
+}
+
+/**
+ * @brief Ajoute la durée de décision d'un tour aux latences relevées.
+ *
+ * @param latences Latences relevées.
+ * @param duree Durée du tour en nanosecondes.
  */
-int kbhit() {
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-    ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-    if (ch != EOF) {
-        ungetc(ch, stdin);
-        return 1;
-    }
-    return 0;
+void enregistrerLatence(tLatences *latences, long duree) {
+    if (latences->nbDurees == latences->capacite) {
+        int capacite = latences->capacite == 0 ? MAX_DEPLACEMENTS : 2 * latences->capacite;
+        long *lesDurees = realloc(latences->lesDurees, capacite * sizeof(long));
+        if (lesDurees == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        latences->lesDurees = lesDurees;
+        latences->capacite = capacite;
+    }
+    latences->lesDurees[latences->nbDurees++] = duree;
+}
+
+/**
+ * @brief Calcule la durée écoulée entre deux instants.
+ *
+ * @param debut Instant de début.
+ * @param fin Instant de fin.
+ * @return La durée en nanosecondes.
+ */
+long dureeNanosecondes(struct timespec debut, struct timespec fin) {
+    return (fin.tv_sec - debut.tv_sec) * 1000000000L + (fin.tv_nsec - debut.tv_nsec);
+}
+
+/**
+ * @brief Compare deux durées pour qsort().
+ *
+ * @param a Pointeur vers la première durée.
+ * @param b Pointeur vers la seconde durée.
+ * @return Un entier négatif, nul ou positif selon que a est plus court, égal ou plus long que b.
+ */
+int comparerDurees(const void *a, const void *b) {
+    long dureeA = *(const long *)a, dureeB = *(const long *)b;
+    return (dureeA > dureeB) - (dureeA < dureeB);
+}
+
+/**
+ * @brief Calcule la médiane, le 99e percentile et le maximum de durées.
+ *
+ * Les durées sont triées sur place.
+ *
+ * @param lesDurees Durées en nanosecondes.
+ * @param nbDurees Nombre de durées.
+ * @param p50 Médiane des durées.
+ * @param p99 99e percentile des durées.
+ * @param max Durée la plus longue.
+ */
+void calculerPercentiles(long lesDurees[], int nbDurees, long *p50, long *p99, long *max) {
+    *p50 = *p99 = *max = 0;
+    if (nbDurees == 0) {
+        return;
+    }
+    qsort(lesDurees, nbDurees, sizeof(long), comparerDurees);
+    *p50 = lesDurees[(long)(nbDurees - 1) * 50 / 100];
+    *p99 = lesDurees[(long)(nbDurees - 1) * 99 / 100];
+    *max = lesDurees[nbDurees - 1];
+}
+
+/**
+ * @brief Passe le terminal en mode brut pour toute la partie.
+ *
+ * Les touches sont lues une à une, sans écho ni attente de la touche Entrée.
+ * Les réglages d'origine sont restaurés par restaurerTerminal() à la sortie
+ * du programme, y compris lorsqu'il est interrompu par un signal.
+ */
+void activerModeBrut() {
+    struct termios terminalBrut;
+
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &terminalInitial) != 0) {
+        return;
+    }
+    terminalBrut = terminalInitial;
+    terminalBrut.c_lflag &= ~(ICANON | ECHO);
+    terminalBrut.c_cc[VMIN] = 0;
+    terminalBrut.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalBrut) != 0) {
+        return;
+    }
+    modeBrutActif = true;
+
+    atexit(restaurerTerminal);
+    signal(SIGINT, interrompreProgramme);
+    signal(SIGTERM, interrompreProgramme);
+    signal(SIGHUP, interrompreProgramme);
+    signal(SIGQUIT, interrompreProgramme);
+}
+
+/**
+ * @brief Rend au terminal les réglages qu'il avait au lancement.
+ */
+void restaurerTerminal() {
+    if (modeBrutActif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial);
+        modeBrutActif = false;
+    }
+}
+
+/**
+ * @brief Restaure le terminal puis termine le programme sur un signal.
+ *
+ * Le signal est renvoyé avec son traitement par défaut pour que le programme
+ * se termine comme s'il n'avait pas été intercepté.
+ *
+ * @param numeroSignal Le signal reçu.
+ */
+void interrompreProgramme(int numeroSignal) {
+    restaurerTerminal();
+    signal(numeroSignal, SIG_DFL);
+    raise(numeroSignal);
+}
+
+/**
+ * @brief Lit une touche si l'une d'elles a été appuyée.
+ *
+ * Cette fonction ne bloque pas : poll() vérifie sans attendre si une touche
+ * est disponible sur l'entrée standard, qui reste en mode brut toute la partie.
+ *
+ * @param touche Touche lue.
+ * @return true si une touche a été lue, false sinon.
+ */
+bool lireTouche(char *touche) {
+    struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+    return poll(&entree, 1, 0) > 0 && read(STDIN_FILENO, touche, 1) == 1;
+}
+
+/**
+ * @brief Démarre la cadence des tours à l'instant présent.
+ *
+ * @param cadence Cadence à démarrer.
+ */
+void demarrerCadence(tCadence *cadence) {
+    clock_gettime(CLOCK_MONOTONIC, &cadence->echeance);
+    cadence->nbRetards = 0;
+}
+
+/**
+ * @brief Attend l'échéance du tour suivant.
+ *
+ * Les échéances sont absolues : chacune tombe ATTENTE microsecondes après la
+ * précédente, quel que soit le temps passé à calculer et afficher le tour, si
+ * bien que la période reste stable et que les écarts ne s'accumulent pas. Un
+ * tour terminé après son échéance est compté comme un retard et le suivant
+ * commence sans attendre. Au-delà de MAX_TOURS_RETARD tours de retard, la
+ * cadence repart de l'instant présent plutôt que d'enchaîner les tours.
+ *
+ * @param cadence Cadence du jeu.
+ * @return true si le tour a dépassé son échéance, false sinon.
+ */
+bool attendreTourSuivant(tCadence *cadence) {
+    struct timespec maintenant;
+    long retard;
+
+    cadence->echeance.tv_nsec += ATTENTE * 1000L;
+    cadence->echeance.tv_sec += cadence->echeance.tv_nsec / 1000000000L;
+    cadence->echeance.tv_nsec %= 1000000000L;
+
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    retard = dureeNanosecondes(cadence->echeance, maintenant);
+    if (retard <= 0) {
+        // L'attente reprend jusqu'à la même échéance si un signal l'interrompt
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &cadence->echeance, NULL) == EINTR) {
+        }
+        return false;
+    }
+
+    cadence->nbRetards++;
+    if (retard > MAX_TOURS_RETARD * ATTENTE * 1000L) {
+        cadence->echeance = maintenant;
+    }
+    return true;
 }
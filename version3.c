@@ -4,8 +4,11 @@
 #include <unistd.h>
 #include <time.h>
 #include <termios.h>
-#include <fcntl.h>
 #include <math.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
 
 /******************************
 *          Constantes         *
@@ -15,7 +18,8 @@
 #define HAUTEUR_PLATEAU 40     ///< Hauteur du plateau
 #define TAILLE 10              ///< Taille fixe du serpent
 #define NB_POMMES 10           ///< Nombre total de pommes à  manger
-#define ATTENTE 200000         ///< Temporisation entre deux déplacements (en microsecondes)
+#define ATTENTE 200000         ///< Période d'un tour (en microsecondes)
+#define MAX_TOURS_RETARD 5     ///< Retard (en tours) au-delà duquel la cadence repart de l'instant présent
 #define CORPS 'X'              ///< Représentation des anneaux du serpent
 #define TETE 'O'               ///< Représentation de la tête du serpent
 #define BORDURE '#'            ///< Représentation des bordures du plateau
@@ -26,20 +30,39 @@
 #define VIDE ' '               ///< Représentation des espaces vides
 #define POMME '6'              ///< Représentation d'une pomme
 #define STOP 'a'               ///< Touche pour arrêter le jeu
+#define OPTION_SANS_AFFICHAGE "--sans-affichage" ///< Option de lancement sans affichage ni temporisation
 
 typedef char tPlateau[LARGEUR_PLATEAU + 1][HAUTEUR_PLATEAU + 1];
 
+/**
+ * Cadence des tours de jeu.
+ */
+typedef struct {
+    struct timespec echeance; ///< Date absolue (CLOCK_MONOTONIC) de la fin du tour en cours
+    int nbRetards;            ///< Nombre de tours terminés après leur échéance
+} tCadence;
+
+bool modeSansAffichage = false; ///< Vrai si la partie est simulée sans terminal (ni affichage, ni attente, ni clavier)
+struct termios terminalInitial;  ///< Réglages du terminal à restaurer en fin de partie
+bool modeBrutActif = false;      ///< Vrai tant que le terminal est en mode brut
+
 // Prototypes des fonctions
 void initPlateau(tPlateau plateau);
 void dessinerPlateau(tPlateau plateau);
 void afficher(int x, int y, char car);
 void effacer(int x, int y);
-void dessinerSerpent(int lesX[], int lesY[]);
-bool collision(int x, int y, int lesX[], int lesY[]);
-void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau, bool *pomme);
+void dessinerSerpent(int lesX[], int lesY[], int indiceTete);
+bool collision(int x, int y, int lesX[], int lesY[], int indiceTete);
+void progresser(int lesX[], int lesY[], int *indiceTete, int cibleX, int cibleY, tPlateau plateau, bool *pomme);
 void gotoxy(int x, int y);
 void finProgramme(int nbDeplacements, clock_t tempsDebut, clock_t tempsFin);
-int kbhit();
+void activerModeBrut();
+void restaurerTerminal();
+void interrompreProgramme(int numeroSignal);
+bool lireTouche(char *touche);
+void demarrerCadence(tCadence *cadence);
+bool attendreTourSuivant(tCadence *cadence);
+long dureeNanosecondes(struct timespec debut, struct timespec fin);
 void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY, int *nouvelleX, int *nouvelleY, bool *utilisePortail);
 
 /**************************************
@@ -54,17 +77,35 @@ void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY
  * Cette fonction gare le jeu, le plateau, le serpent, les pommes, et le mouvement du serpent.
  * Elle gare également l'affichage du nombre de déplacements et du temps d'exécution du jeu.
  *
+ * Lancé avec l'option --sans-affichage, le jeu est simulé sans affichage ni
+ * temporisation et seules les statistiques de fin sont affichées.
+ *
+ * @param argc Nombre d'arguments de la ligne de commande.
+ * @param argv Arguments de la ligne de commande.
  * @return EXIT_SUCCESS si le programme s'est exécuté avec succas.
  */
-int main() {
+int main(int argc, char *argv[]) {
     tPlateau lePlateau;
     int lesX[TAILLE], lesY[TAILLE];
+    int indiceTete = 0;
     int lesPommesX[NB_POMMES] = {75, 75, 78, 2, 8, 78, 74, 2, 72, 5};
     int lesPommesY[NB_POMMES] = {8, 39, 2, 2, 5, 39, 33, 38, 35, 2};
     int nbDeplacements = 0;
     int indexPomme = 0;
     bool pommeMangee = false;
     char touche;
+    tCadence cadence;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], OPTION_SANS_AFFICHAGE) == 0) {
+            modeSansAffichage = true;
+        }
+    }
+
+    // Le terminal passe une seule fois en mode brut pour toute la partie
+    if (!modeSansAffichage) {
+        activerModeBrut();
+    }
 
     clock_t tempsDebut = clock();
 
@@ -76,19 +117,19 @@ int main() {
     initPlateau(lePlateau);
     dessinerPlateau(lePlateau);
     afficher(lesPommesX[indexPomme], lesPommesY[indexPomme], POMME);
-    dessinerSerpent(lesX, lesY);
+    dessinerSerpent(lesX, lesY, indiceTete);
 
+    demarrerCadence(&cadence);
     while (indexPomme < NB_POMMES) {
-        if (kbhit()) {
-            touche = getchar();
-            if (touche == STOP) {
-                break;
-            }
+        if (!modeSansAffichage && lireTouche(&touche) && touche == STOP) {
+            break;
         }
 
-        progresser(lesX, lesY, lesPommesX[indexPomme], lesPommesY[indexPomme], lePlateau, &pommeMangee);
+        progresser(lesX, lesY, &indiceTete, lesPommesX[indexPomme], lesPommesY[indexPomme], lePlateau, &pommeMangee);
         nbDeplacements++;
-        usleep(ATTENTE);
+        if (!modeSansAffichage) {
+            attendreTourSuivant(&cadence);
+        }
 
         if (pommeMangee) {
             indexPomme++;
@@ -101,6 +142,9 @@ int main() {
 
     clock_t tempsFin = clock();
     finProgramme(nbDeplacements, tempsDebut, tempsFin);
+    if (!modeSansAffichage) {
+        printf("Tours en retard : %d\n", cadence.nbRetards);
+    }
     return EXIT_SUCCESS;
 }
 
@@ -215,11 +259,11 @@ void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY
 }
 
 
-// Fonction pour vérifier les collisions avec le corps du serpent
-bool collision(int x, int y, int lesX[], int lesY[]) {
+// Fonction pour vérifier les collisions avec le corps du serpent (toutes les cases sauf la tête)
+bool collision(int x, int y, int lesX[], int lesY[], int indiceTete) {
     bool res = false;
-    for (int i = 1; i < TAILLE; i++) {
-        if (lesX[i] == x && lesY[i] == y) {
+    for (int i = 0; i < TAILLE; i++) {
+        if (i != indiceTete && lesX[i] == x && lesY[i] == y) {
             res = true; // Il y a une collision
             break; // Sort de la boucle das qu'une collision est détectée
         }
@@ -235,39 +279,43 @@ bool collision(int x, int y, int lesX[], int lesY[]) {
  *
  * @param lesX Tableau des positions X des segments du serpent.
  * @param lesY Tableau des positions Y des segments du serpent.
+ * @param indiceTete Pointeur vers l'indice de la tête dans les tableaux circulaires.
  * @param cibleX Position X de la cible (pomme ou portail).
  * @param cibleY Position Y de la cible (pomme ou portail).
  * @param plateau Le plateau de jeu.
  * @param pomme Pointeur vers une variable booléenne indiquant si la pomme est mangée.
  */
-void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau, bool *pomme) {
+void progresser(int lesX[], int lesY[], int *indiceTete, int cibleX, int cibleY, tPlateau plateau, bool *pomme) {
+    int tete = *indiceTete;
     int prochainX = cibleX, prochainY = cibleY;
 
+    // La queue occupe la case qui précède la tête dans le tableau circulaire
+    tete = (tete + TAILLE - 1) % TAILLE;
+
     // Efface le dernier segment du serpent
-    effacer(lesX[TAILLE - 1], lesY[TAILLE - 1]);
+    effacer(lesX[tete], lesY[tete]);
 
-    // Déplace les segments du corps
-    for (int i = TAILLE - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
-    }
+    // La case de la queue devient la nouvelle tête : le corps ne bouge pas
+    lesX[tete] = lesX[*indiceTete];
+    lesY[tete] = lesY[*indiceTete];
+    *indiceTete = tete;
 
     // Déplacement optimal vers la cible en évitant les collisions avec le corps du serpent et les bordures
-    if (lesY[0] < cibleY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY)) {
-        lesY[0]++;
-    } else if (lesY[0] > cibleY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY)) {
-        lesY[0]--;
-    } else if (lesX[0] < cibleX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY)) {
-        lesX[0]++;
-    } else if (lesX[0] > cibleX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY)) {
-        lesX[0]--;
+    if (lesY[tete] < cibleY && plateau[lesX[tete]][lesY[tete] + 1] != BORDURE && !collision(lesX[tete], lesY[tete] + 1, lesX, lesY, tete)) {
+        lesY[tete]++;
+    } else if (lesY[tete] > cibleY && plateau[lesX[tete]][lesY[tete] - 1] != BORDURE && !collision(lesX[tete], lesY[tete] - 1, lesX, lesY, tete)) {
+        lesY[tete]--;
+    } else if (lesX[tete] < cibleX && plateau[lesX[tete] + 1][lesY[tete]] != BORDURE && !collision(lesX[tete] + 1, lesY[tete], lesX, lesY, tete)) {
+        lesX[tete]++;
+    } else if (lesX[tete] > cibleX && plateau[lesX[tete] - 1][lesY[tete]] != BORDURE && !collision(lesX[tete] - 1, lesY[tete], lesX, lesY, tete)) {
+        lesX[tete]--;
     }
 
     // Vérifie si la tête du serpent atteint la pomme
-    *pomme = (lesX[0] == cibleX && lesY[0] == cibleY);
+    *pomme = (lesX[tete] == cibleX && lesY[tete] == cibleY);
 
     // Redessine le serpent
-    dessinerSerpent(lesX, lesY);
+    dessinerSerpent(lesX, lesY, tete);
 }
 
 
@@ -280,6 +328,9 @@ void progresser(int lesX[], int lesY[], int cibleX, int cibleY, tPlateau plateau
  * @param plateau Le plateau de jeu.
  */
 void dessinerPlateau(tPlateau plateau) {
+    if (modeSansAffichage) {
+        return;
+    }
     for (int i = 1; i <= LARGEUR_PLATEAU; i++) {
         for (int j = 1; j <= HAUTEUR_PLATEAU; j++) {
             afficher(i, j, plateau[i][j]);
@@ -297,6 +348,9 @@ void dessinerPlateau(tPlateau plateau) {
  * @param car Caractare à  afficher.
  */
 void afficher(int x, int y, char car) {
+    if (modeSansAffichage) {
+        return;
+    }
     gotoxy(x, y);
     printf("%c", car);
     fflush(stdout);
@@ -322,11 +376,12 @@ void effacer(int x, int y) {
  *
  * @param lesX Tableau des positions X des segments du serpent.
  * @param lesY Tableau des positions Y des segments du serpent.
+ * @param indiceTete Indice de la tête dans les tableaux circulaires.
  */
-void dessinerSerpent(int lesX[], int lesY[]) {
-    afficher(lesX[0], lesY[0], TETE);
+void dessinerSerpent(int lesX[], int lesY[], int indiceTete) {
+    afficher(lesX[indiceTete], lesY[indiceTete], TETE);
     for (int i = 1; i < TAILLE; i++) {
-        afficher(lesX[i], lesY[i], CORPS);
+        afficher(lesX[(indiceTete + i) % TAILLE], lesY[(indiceTete + i) % TAILLE], CORPS);
     }
 }
 
@@ -361,28 +416,126 @@ void finProgramme(int nbDeplacements, clock_t tempsDebut, clock_t tempsFin) {
 }
 
 /**
- * @brief Vérifie si une touche a été appuyée.
+ * @brief Passe le terminal en mode brut pour toute la partie.
  *
- * Cette fonction vérifie si une touche a été appuyée sur le clavier.
+ * Les touches sont lues une à une, sans écho ni attente de la touche Entrée.
+ * Les réglages d'origine sont restaurés par restaurerTerminal() à la sortie
+ * du programme, y compris lorsqu'il est interrompu par un signal.
+ */
+void activerModeBrut() {
+    struct termios terminalBrut;
+
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &terminalInitial) != 0) {
+        return;
+    }
+    terminalBrut = terminalInitial;
+    terminalBrut.c_lflag &= ~(ICANON | ECHO);
+    terminalBrut.c_cc[VMIN] = 0;
+    terminalBrut.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalBrut) != 0) {
+        return;
+    }
+    modeBrutActif = true;
+
+    atexit(restaurerTerminal);
+    signal(SIGINT, interrompreProgramme);
+    signal(SIGTERM, interrompreProgramme);
+    signal(SIGHUP, interrompreProgramme);
+    signal(SIGQUIT, interrompreProgramme);
+}
+
+/**
+ * @brief Rend au terminal les réglages qu'il avait au lancement.
+ */
+void restaurerTerminal() {
+    if (modeBrutActif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial);
+        modeBrutActif = false;
+    }
+}
+
+/**
+ * @brief Restaure le terminal puis termine le programme sur un signal.
  *
- * @return 1 si une touche a été appuyée, 0 sinon.
+ * Le signal est renvoyé avec son traitement par défaut pour que le programme
+ * se termine comme s'il n'avait pas été intercepté.
+ *
+ * @param numeroSignal Le signal reçu.
  */
-int kbhit() {
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-    ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-    if (ch != EOF) {
-        ungetc(ch, stdin);
-        return 1;
+void interrompreProgramme(int numeroSignal) {
+    restaurerTerminal();
+    signal(numeroSignal, SIG_DFL);
+    raise(numeroSignal);
+}
+
+/**
+ * @brief Lit une touche si l'une d'elles a été appuyée.
+ *
+ * Cette fonction ne bloque pas : poll() vérifie sans attendre si une touche
+ * est disponible sur l'entrée standard, qui reste en mode brut toute la partie.
+ *
+ * @param touche Touche lue.
+ * @return true si une touche a été lue, false sinon.
+ */
+bool lireTouche(char *touche) {
+    struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+    return poll(&entree, 1, 0) > 0 && read(STDIN_FILENO, touche, 1) == 1;
+}
+
+/**
+ * @brief Démarre la cadence des tours à l'instant présent.
+ *
+ * @param cadence Cadence à démarrer.
+ */
+void demarrerCadence(tCadence *cadence) {
+    clock_gettime(CLOCK_MONOTONIC, &cadence->echeance);
+    cadence->nbRetards = 0;
+}
+
+/**
+ * @brief Attend l'échéance du tour suivant.
+ *
+ * Les échéances sont absolues : chacune tombe ATTENTE microsecondes après la
+ * précédente, quel que soit le temps passé à calculer et afficher le tour, si
+ * bien que la période reste stable et que les écarts ne s'accumulent pas. Un
+ * tour terminé après son échéance est compté comme un retard et le suivant
+ * commence sans attendre. Au-delà de MAX_TOURS_RETARD tours de retard, la
+ * cadence repart de l'instant présent plutôt que d'enchaîner les tours.
+ *
+ * @param cadence Cadence du jeu.
+ * @return true si le tour a dépassé son échéance, false sinon.
+ */
+bool attendreTourSuivant(tCadence *cadence) {
+    struct timespec maintenant;
+    long retard;
+
+    cadence->echeance.tv_nsec += ATTENTE * 1000L;
+    cadence->echeance.tv_sec += cadence->echeance.tv_nsec / 1000000000L;
+    cadence->echeance.tv_nsec %= 1000000000L;
+
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    retard = dureeNanosecondes(cadence->echeance, maintenant);
+    if (retard <= 0) {
+        // L'attente reprend jusqu'à la même échéance si un signal l'interrompt
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &cadence->echeance, NULL) == EINTR) {
+        }
+        return false;
+    }
+
+    cadence->nbRetards++;
+    if (retard > MAX_TOURS_RETARD * ATTENTE * 1000L) {
+        cadence->echeance = maintenant;
     }
-    return 0;
-}
\ No newline at end of file
+    return true;
+}
+
+/**
+ * @brief Calcule la durée écoulée entre deux instants.
+ *
+ * @param debut Instant de début.
+ * @param fin Instant de fin.
+ * @return La durée en nanosecondes.
+ */
+long dureeNanosecondes(struct timespec debut, struct timespec fin) {
+    return (fin.tv_sec - debut.tv_sec) * 1000000000L + (fin.tv_nsec - debut.tv_nsec);
+}
@@ -4,18 +4,58 @@
 #include <unistd.h>
 #include <time.h>
 #include <termios.h>
-#include <fcntl.h>
 #include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 /******************************
 *  Constantes                *
 *                             *
 ****************************** */
-#define LARGEUR_PLATEAU 80     ///< Largeur du plateau
-#define HAUTEUR_PLATEAU 40     ///< Hauteur du plateau
-#define TAILLE 10              ///< Taille fixe du serpent
+#define LARGEUR_PLATEAU 80     ///< Largeur du plateau par défaut
+#define HAUTEUR_PLATEAU 40     ///< Hauteur du plateau par défaut
+#define LARGEUR_MIN 40         ///< Largeur minimale du plateau
+#define HAUTEUR_MIN 30         ///< Hauteur minimale du plateau
+#define DIMENSION_MAX 10000    ///< Largeur et hauteur maximales du plateau
+#define LARGEUR_ECRAN LARGEUR_PLATEAU ///< Largeur de la zone affichée (coin haut gauche des grands plateaux)
+#define HAUTEUR_ECRAN HAUTEUR_PLATEAU ///< Hauteur de la zone affichée
+#define TAILLE_TUILE 64        ///< Côté (en cases) d'une tuile des grilles du plateau (un mot de 64 bits par rangée dans les couches)
+#define TAILLE 10              ///< Taille initiale du serpent
+#define CAPACITE_ANNEAUX 16    ///< Capacité initiale du tableau des anneaux (puissance de 2, au moins TAILLE)
+#define CROISSANCE_DEFAUT 0    ///< Anneaux gagnés par pomme mangée par défaut (serpents de taille fixe)
 #define NB_POMMES 10           ///< Nombre total de pommes à  manger
-#define ATTENTE 200000          ///< Temporisation entre deux déplacements (en microsecondes)
+#define NB_POMMES_PLANIFIEES 3 ///< Pommes dont le champ de distances est tenu à jour : la pomme visée et les suivantes
+#define MEMOIRE_CHAMPS (64L << 20) ///< Mémoire (en octets) des champs de distances au-delà de laquelle seule la pomme visée a le sien
+#define FENETRE_RESERVATIONS 3 ///< Nombre de pas à venir réservés par chaque serpent (option --reservations)
+#define ANNEAUX_MCTS 64        ///< Anneaux d'un serpent retenus dans l'état compact de l'agent MCTS (voir tEtatMcts)
+#define NOEUDS_MCTS 65536      ///< Nœuds de l'arbre de chaque fil de l'agent MCTS
+#define HORIZON_MCTS 48        ///< Coups (des deux serpents) simulés au-delà de la racine
+#define EXPLORATION_MCTS 1.0   ///< Constante d'exploration de la formule UCB1
+#define BUDGET_MCTS 10         ///< Temps de réflexion par tour de l'agent MCTS par défaut (en millisecondes)
+#define NB_FILS_MCTS 4         ///< Nombre de fils d'exécution de l'agent MCTS par défaut
+#define NB_FILS_MCTS_MAX 64    ///< Nombre maximal de fils d'exécution de l'agent MCTS
+#define ENTREES_TRANSPOSITION (1 << 20) ///< Entrées de la table de transposition de l'agent alpha-bêta (puissance de 2)
+#define PROFONDEUR_MAX_ALPHABETA 64 ///< Profondeur (en coups des deux serpents) où s'arrête l'approfondissement
+#define BUDGET_ALPHABETA 10    ///< Échéance par tour de l'agent alpha-bêta par défaut (en millisecondes)
+#define NB_FILS_ALPHABETA 1    ///< Nombre de fils d'exécution de l'agent alpha-bêta par défaut
+#define NOEUDS_ENTRE_HORLOGES 256 ///< Nœuds explorés par l'agent alpha-bêta entre deux lectures de l'horloge
+#define POINTS_POMME 1000      ///< Valeur d'une pomme d'écart dans l'évaluation alpha-bêta (un pas vers la pomme vaut 1)
+#define SCORE_INFINI 1000000   ///< Score plus grand que toute évaluation alpha-bêta
+#define BORNE_EXACTE 0         ///< Score exact d'une entrée de la table de transposition
+#define BORNE_INFERIEURE 1     ///< Score minimal (coupure beta) d'une entrée de la table de transposition
+#define BORNE_SUPERIEURE 2     ///< Score maximal (aucun coup n'a dépassé alpha) d'une entrée de la table de transposition
+#define ZOBRIST_CORPS 0        ///< Élément de clé Zobrist : anneau du serpent 0 (ZOBRIST_CORPS + 1 pour le serpent 1) sur une case
+#define ZOBRIST_TETE 2         ///< Élément de clé Zobrist : tête d'un serpent sur une case
+#define ZOBRIST_GRANDIR 4      ///< Élément de clé Zobrist : anneaux restant à gagner par un serpent
+#define ZOBRIST_POMME 6        ///< Élément de clé Zobrist : indice de la pomme présente
+#define ZOBRIST_TRAIT 7        ///< Élément de clé Zobrist : second serpent au trait
+#define ATTENTE 200000          ///< Période d'un tour (en microsecondes)
+#define MAX_TOURS_RETARD 5     ///< Retard (en tours) au-delà duquel la cadence repart de l'instant présent
 #define CORPS 'X'              ///< Représentation des anneaux du serpent
 #define TETE 'O'               ///< Représentation de la tête du serpent
 #define BORDURE '#'            ///< Représentation des bordures du plateau
@@ -26,26 +66,641 @@
 #define VIDE ' '               ///< Représentation des espaces vides
 #define POMME '6'              ///< Représentation d'une pomme
 #define STOP 'a'               ///< Touche pour arrêter le jeu
-#define POSITION_DEP_X_1 40 
-#define POSITION_DEP_Y_1 13
-#define POSITION_DEP_X_2 40
-#define POSITION_DEP_Y_2 27
+#define OPTION_SANS_AFFICHAGE "--sans-affichage" ///< Option de lancement sans affichage ni temporisation
+#define OPTION_PLATEAU "--plateau="       ///< Option des dimensions du plateau (LARGEURxHAUTEUR)
+#define OPTION_SERPENTS "--serpents="     ///< Option du nombre de serpents dans l'arène
+#define OPTION_CROISSANCE "--croissance=" ///< Option du nombre d'anneaux gagnés par pomme mangée
+#define OPTION_SAUT_IMAGES "--sauter-images" ///< Option autorisant à sauter l'affichage des tours en retard
+#define OPTION_DETOURS_INCREMENTAUX "--detours-incrementaux" ///< Option des détours réparés d'un tour à l'autre (voir tPlanificateur)
+#define OPTION_COOPERATIF "--cooperatif"   ///< Option de la répartition des prochaines pommes entre les serpents (voir repartirPommes())
+#define OPTION_RESERVATIONS "--reservations" ///< Option de la réservation des prochains pas de chaque serpent (voir reserverPlan())
+#define OPTION_MCTS "--mcts"               ///< Option confiant le premier serpent à l'agent MCTS (voir deciderMcts())
+#define OPTION_BUDGET_MCTS "--budget-mcts=" ///< Option du temps de réflexion par tour de l'agent MCTS (en millisecondes)
+#define OPTION_FILS_MCTS "--fils-mcts="    ///< Option du nombre de fils d'exécution de l'agent MCTS
+#define OPTION_ALPHABETA "--alphabeta"     ///< Option confiant le premier serpent à l'agent alpha-bêta (voir deciderAlphaBeta())
+#define OPTION_BUDGET_ALPHABETA "--budget-alphabeta=" ///< Option de l'échéance par tour de l'agent alpha-bêta (en millisecondes)
+#define OPTION_FILS_ALPHABETA "--fils-alphabeta=" ///< Option du nombre de fils d'exécution de l'agent alpha-bêta
+#define OPTION_BENCHMARK "--benchmark"     ///< Option de lancement d'une série de parties chronométrées
+#define OPTION_PARTIES "--parties="        ///< Option du nombre de parties du benchmark
+#define OPTION_GRAINE "--graine="          ///< Option de la graine de la première partie du benchmark
+#define OPTION_DISPOSITION "--disposition=" ///< Option de la disposition des pommes (fixe ou aleatoire)
+#define OPTION_CSV "--csv="                ///< Option du fichier CSV où ajouter les résultats du benchmark
+#define DISPOSITION_ALEATOIRE "aleatoire"  ///< Pavés et pommes tirés au hasard à partir de la graine de chaque partie
+#define FLUX_POMMES 1                      ///< Flux du générateur réservé au tirage des pommes
+#define FLUX_PAVES 2                       ///< Flux du générateur réservé au tirage des pavés
+#define NB_PARTIES_DEFAUT 100              ///< Nombre de parties du benchmark par défaut
+#define MAX_DEPLACEMENTS 20000             ///< Nombre de tours au-delà duquel une partie du benchmark est abandonnée
+#define NOM_VARIANTE "version4-5"               ///< Nom de la variante dans les résultats du benchmark
+#define POSITION_DEP_X_1 (largeurPlateau / 2)
+#define POSITION_DEP_Y_1 (hauteurPlateau / 2 - 7)
+#define POSITION_DEP_X_2 (largeurPlateau / 2)
+#define POSITION_DEP_Y_2 (hauteurPlateau / 2 + 7)
+#define NB_SERPENTS 2           ///< Nombre de serpents par défaut
+#define NB_SERPENTS_MAX 1000    ///< Nombre maximal de serpents dans l'arène
+#define NB_DIRECTIONS 4         ///< Nombre de déplacements possibles depuis une case
+#define TOUTES_DIRECTIONS ((1 << NB_DIRECTIONS) - 1) ///< Masque où les quatre voisins sont libres
+#define AUCUNE_DIRECTION -1     ///< Direction d'arrivée du nœud de départ d'une recherche
+#define DIRECTION_OPPOSEE(direction) ((direction) ^ 1)    ///< Direction inverse (bas et haut, droite et gauche)
+#define DIRECTION_VERTICALE(direction) ((direction) < 2)  ///< Vrai pour bas et haut
+#define ANNEAU(serpent, i) ((serpent)->lesAnneaux[((serpent)->indiceTete + (i)) & ((serpent)->capacite - 1)]) ///< Anneau numéro i d'un serpent (0 pour la tête)
+#define AUCUN_NOEUD -1          ///< Nœud d'une case pas encore atteinte par la recherche A*, parent du nœud de départ
+#define OCTET_AUCUN_NOEUD 0xFF  ///< Octet qui, répété, donne AUCUN_NOEUD
+#define INFINI 0x3F3F3F3F       ///< Distance d'une case d'où le planificateur ne connaît pas de chemin vers la pomme
+#define OCTET_INFINI 0x3F       ///< Octet qui, répété, donne INFINI
+#define DISTANCE_INCONNUE -1    ///< Distance d'une case qui ne mène pas à la pomme
+#define CASES_PAR_LIGNE_CACHE 32 ///< Cases d'un champ de distances par ligne de cache (64 octets de short)
+#define LARGEUR_RANGEE (((largeurPlateau + 1 + CASES_PAR_LIGNE_CACHE - 1) / CASES_PAR_LIGNE_CACHE) * CASES_PAR_LIGNE_CACHE) ///< Rangée d'un champ de distances complétée à un nombre entier de lignes de cache
+#define INDICE_CASE(x, y) ((y) * LARGEUR_RANGEE + (x))   ///< Numéro unique d'une case du plateau, rangée par rangée
+#define CASE_X(indice) ((indice) % LARGEUR_RANGEE)       ///< Position X de la case d'indice donné
+#define CASE_Y(indice) ((indice) / LARGEUR_RANGEE)       ///< Position Y de la case d'indice donné
+#define NB_INDICES_CASES ((size_t)(hauteurPlateau + 1) * LARGEUR_RANGEE) ///< Nombre d'indices de cases, rangées complétées comprises
+#define BITS_PAR_MOT 64         ///< Nombre de cases d'un mot de tBitboard
+#define DEMI_PERIMETRE_MAX_BITS 800 ///< Largeur + hauteur au-delà de laquelle le parcours case par case bat le parcours par bits
+#define MOT_BITBOARD(bitboard, y, mot) ((bitboard)->lesMots[(size_t)(y) * (bitboard)->nbMots + (mot)]) ///< Mot numéro mot de la rangée y d'un tBitboard
+#define TAILLE_TAMPON_ECRAN (LARGEUR_ECRAN * HAUTEUR_ECRAN * 12) ///< Taille maximale d'une trame (séquence de positionnement + caractère par case)
 
-typedef char tPlateau[LARGEUR_PLATEAU + 1][HAUTEUR_PLATEAU + 1];
+/**
+ * Grille d'un caractère par case, allouée sur le tas et découpée en tuiles de
+ * TAILLE_TUILE × TAILLE_TUILE cases. Une tuile n'est allouée qu'au premier
+ * caractère différent de la valeur par défaut qui y est écrit : un grand
+ * plateau presque vide n'occupe en mémoire que les tuiles qui contiennent ses
+ * bordures, ses pavés et les serpents.
+ *
+ * Tuiles et cases sont rangées rangée par rangée, comme l'écran : une rangée
+ * de tuile occupe TAILLE_TUILE octets contigus, soit une ligne de cache, et
+ * les parcours en y puis en x lisent la mémoire dans l'ordre.
+ */
+typedef struct {
+    int largeur, hauteur;      ///< Nombre de cases en X et en Y
+    int nbTuilesX, nbTuilesY;  ///< Nombre de tuiles en X et en Y
+    char defaut;               ///< Valeur des cases des tuiles non allouées
+    char **lesTuiles;          ///< Tuiles rangées rangée de tuiles par rangée de tuiles, NULL si non allouée
+} tGrille;
+
+/**
+ * Couche de bits du plateau : un bit par case, découpée comme tGrille en
+ * tuiles de TAILLE_TUILE × TAILLE_TUILE cases. Une tuile est un tableau de
+ * TAILLE_TUILE mots de 64 bits, un mot par rangée : le bit x % TAILLE_TUILE du
+ * mot y % TAILLE_TUILE est celui de la case (x, y). Les cases voisines d'une
+ * même rangée tombent ainsi dans le même mot et se testent ensemble.
+ */
+typedef struct {
+    int nbTuilesX, nbTuilesY;  ///< Nombre de tuiles en X et en Y
+    uint64_t **lesTuiles;      ///< Tuiles rangées comme celles de tGrille, NULL si toutes leurs cases sont à 0
+} tCouche;
+
+/**
+ * Plateau de jeu, indexé de 1 à largeurPlateau et de 1 à hauteurPlateau. Les
+ * tests de déplacement ne lisent que les couches de bits ; les caractères ne
+ * servent qu'à l'affichage.
+ */
+typedef struct {
+    tCouche bordures;  ///< Cases de bordure (les portails n'en font pas partie)
+    tCouche paves;     ///< Cases des pavés
+    tGrille rendu;     ///< Caractère affiché pour chaque case (VIDE par défaut)
+} tPlateau;
+/**
+ * Journal des cases dont l'occupation a changé : case prise par une tête ou
+ * libérée par une queue. Les changements sont numérotés depuis le début de la
+ * partie ; les planificateurs y relisent ceux survenus depuis leur dernier
+ * appel, et ceux que plus aucun planificateur n'attend sont oubliés.
+ */
+typedef struct {
+    int *lesCases;  ///< Indices (INDICE_CASE) des cases changées, du plus ancien au plus récent
+    int nbCases;    ///< Nombre de changements conservés
+    int capacite;   ///< Nombre de changements que peut contenir lesCases
+    long premier;   ///< Numéro du changement lesCases[0]
+} tJournal;
+
+/**
+ * File de cases à visiter par un parcours en largeur, en tableau circulaire
+ * agrandi à la demande : sa taille suit le front du parcours et non la
+ * surface du plateau.
+ */
+typedef struct {
+    int *lesCases;  ///< Indices (INDICE_CASE) des cases en attente
+    int capacite;   ///< Nombre de cases que peut contenir lesCases
+    int debut;      ///< Position de la prochaine case à sortir
+    int nbCases;    ///< Nombre de cases en attente
+} tFile;
+
+/**
+ * Plateau entier en bits, rangée par rangée : la case (x, y) est le bit
+ * x % BITS_PAR_MOT du mot x / BITS_PAR_MOT de la rangée y. Contrairement aux
+ * couches en tuiles, les rangées sont contiguës pour que le parcours en
+ * largeur par bits traite une rangée entière d'un seul balayage.
+ */
+typedef struct {
+    int nbMots;          ///< Nombre de mots par rangée
+    uint64_t *lesMots;   ///< Rangées 0 à hauteurPlateau mises bout à bout
+} tBitboard;
+
+/**
+ * Mémoire des parcours en largeur qui calculent les champs de distances (voir
+ * calculerDistances()), conservée d'un champ à l'autre. Seuls les tableaux du
+ * parcours adapté à la taille du plateau sont alloués, au premier calcul.
+ */
+typedef struct {
+    tBitboard libres;      ///< Cases ni bordure ni pavé (parcours par bits)
+    tBitboard atteintes;   ///< Cases déjà atteintes (parcours par bits)
+    tBitboard frontiere;   ///< Cases atteintes au dernier pas (parcours par bits)
+    tBitboard suivante;    ///< Cases atteintes au pas en cours (parcours par bits)
+    tFile file;            ///< Cases à visiter (parcours case par case)
+} tParcours;
+
+/**
+ * Champs de distances des prochaines pommes, dans l'ordre où elles seront
+ * mangées. Chaque champ est calculé une seule fois, quand sa pomme entre dans
+ * la fenêtre ; quand la pomme visée est mangée, les champs suivants sont
+ * décalés sans être recalculés.
+ *
+ * Chaque champ couvre tout le plateau : sur les plus grands, la fenêtre est
+ * réduite pour que les champs tiennent dans MEMOIRE_CHAMPS, jusqu'à ne garder
+ * que celui de la pomme visée.
+ */
+typedef struct {
+    short *lesChamps[NB_POMMES_PLANIFIEES]; ///< Champ de distances (voir calculerDistances()) de la pomme premiere + i
+    int premiere;                           ///< Indice de la pomme de lesChamps[0], -1 avant le premier calcul
+    int pommeX;                             ///< Position X de la pomme premiere, seule présente sur le plateau
+    int pommeY;                             ///< Position Y de la pomme premiere
+    int nbChamps;                           ///< Nombre de champs à jour, moins de capacite en fin de partie
+    int capacite;                           ///< Nombre de champs alloués, de 1 à NB_POMMES_PLANIFIEES
+    tParcours parcours;                     ///< Mémoire des parcours qui calculent les champs
+} tItineraire;
+
+/**
+ * Chemin calculé vers une cible : suite des cases à parcourir depuis la case de
+ * départ (exclue) jusqu'à la cible (incluse).
+ */
+typedef struct {
+    int *lesX;                       ///< Positions X des pas du chemin
+    int *lesY;                       ///< Positions Y des pas du chemin
+    int capacite;                    ///< Nombre de pas que peuvent contenir lesX et lesY
+    int longueur;                    ///< Nombre de pas du chemin
+    int etape;                       ///< Indice du prochain pas à jouer
+    int departX, departY;            ///< Case d'où le chemin a été calculé
+    int cibleX, cibleY;              ///< Cible visée par le chemin
+    bool atteintCible;               ///< Faux si le chemin s'arrête au plus près d'une cible inaccessible
+} tChemin;
+
+/**
+ * Nœud de la recherche A* : une case atteinte par un certain chemin. Une case
+ * atteinte ensuite par un chemin plus court reçoit un nouveau nœud, l'ancien
+ * étant ignoré à sa sortie du tas. Dans la recherche par sauts, le parent
+ * peut être à plusieurs pas, en ligne droite.
+ */
+typedef struct {
+    int indice;      ///< Indice (INDICE_CASE) de la case
+    int cout;        ///< Nombre de pas depuis le départ
+    int estimation;  ///< Estimation du nombre de pas restants (calculerDistanceOptimale())
+    int parent;      ///< Nœud d'où l'on vient, AUCUN_NOEUD pour le départ
+    int direction;   ///< Direction de la ligne droite qui mène du parent à la case, AUCUNE_DIRECTION pour le départ
+    bool ferme;      ///< Vrai une fois le nœud développé
+} tNoeud;
+
+/**
+ * Valeurs par case d'une recherche, conservées d'une recherche à l'autre.
+ *
+ * Les cases sont rangées dans des tuiles de TAILLE_TUILE × TAILLE_TUILE cases,
+ * allouées à la première visite. Au lieu d'effacer les tuiles entre deux
+ * recherches, chacune retient la génération (la recherche) pour laquelle elle a
+ * été remplie d'octetVide : une tuile d'une génération précédente n'est
+ * effacée que si la nouvelle recherche y passe.
+ */
+typedef struct {
+    int nbTuilesX, nbTuilesY;      ///< Nombre de tuiles en X et en Y
+    size_t tailleCase;             ///< Nombre d'octets d'une case
+    unsigned char octetVide;       ///< Octet qui remplit les cases d'une tuile effacée
+    char **lesTuiles;              ///< Tuiles rangées comme celles de tGrille, NULL si jamais visitée
+    unsigned int *lesGenerations;  ///< Génération pour laquelle chaque tuile a été effacée
+    unsigned int generation;       ///< Génération en cours
+} tMemoireTuiles;
+
+/**
+ * Mémoire de la recherche A*, conservée d'une recherche à l'autre pour
+ * qu'aucune allocation n'ait lieu une fois les tableaux à leur taille.
+ */
+typedef struct {
+    tMemoireTuiles noeuds;         ///< Nœud (int) de chaque case, AUCUN_NOEUD si elle n'a pas été atteinte
+    tNoeud *lesNoeuds;             ///< Nœuds créés par la recherche en cours
+    int nbNoeuds;                  ///< Nombre de nœuds créés
+    int capaciteNoeuds;            ///< Nombre de nœuds que peut contenir lesNoeuds
+    int *leTas;                    ///< Tas binaire des nœuds ouverts, le plus prometteur en tête
+    int nbOuverts;                 ///< Nombre de nœuds dans le tas
+    int capaciteTas;               ///< Nombre de nœuds que peut contenir leTas
+} tRecherche;
+
+/**
+ * Valeurs d'une case pour le planificateur incrémental (D* Lite).
+ */
+typedef struct {
+    int distance;   ///< Distance à la pomme établie (g), INFINI si inconnue
+    int prevision;  ///< Distance déduite des voisins (rhs) ; la case est à revoir tant qu'elle diffère de distance
+} tCouts;
+
+/**
+ * Case en attente dans le tas du planificateur, avec la clé qu'elle avait en
+ * y entrant.
+ */
+typedef struct {
+    int cle;        ///< Première clé : distance estimée du trajet tête-case-pomme
+    int cleSecond;  ///< Seconde clé, à égalité : distance à la pomme
+    int indice;     ///< Indice (INDICE_CASE) de la case
+} tEntree;
+
+/**
+ * Planificateur incrémental d'un serpent (D* Lite) : les distances à la pomme
+ * sont cherchées depuis la pomme vers la tête, et conservées d'un tour à
+ * l'autre. À chaque tour, seules les cases dont l'occupation a changé (voir
+ * tJournal) et leurs voisines sont revues, puis la recherche ne reprend que
+ * là où ces changements modifient le chemin de la tête.
+ */
+typedef struct {
+    bool actif;             ///< Vrai si l'état est à jour pour la cible et les changements lus
+    int cibleX, cibleY;     ///< Pomme visée, racine de la recherche
+    int departX, departY;   ///< Tête du serpent au dernier appel
+    int correction;         ///< Somme des estimations entre les têtes successives (km), ajoutée aux clés
+    long changementsLus;    ///< Numéro du prochain changement du journal à relire
+    tMemoireTuiles couts;   ///< tCouts de chaque case
+    tEntree *leTas;         ///< Tas binaire des cases à revoir, les entrées périmées n'étant écartées qu'à leur sortie
+    int nbEntrees;          ///< Nombre d'entrées dans le tas
+    int capaciteTas;        ///< Nombre d'entrées que peut contenir leTas
+} tPlanificateur;
+
+/**
+ * Position d'un anneau. DIMENSION_MAX tenant sur 16 bits, un anneau n'occupe
+ * que 4 octets : un serpent qui remplit le plateau d'origine tient en 13 Ko.
+ */
+typedef struct {
+    uint16_t x;  ///< Position X de l'anneau
+    uint16_t y;  ///< Position Y de l'anneau
+} tAnneau;
+
+/**
+ * Un serpent de l'arène : son corps et le détour qu'il est en train de suivre.
+ */
+typedef struct {
+    tAnneau *lesAnneaux;  ///< Anneaux en tableau circulaire (voir ANNEAU())
+    int capacite;         ///< Nombre d'anneaux que peut contenir lesAnneaux, puissance de 2
+    int indiceTete;       ///< Indice de la tête dans lesAnneaux
+    int taille;           ///< Nombre d'anneaux du serpent
+    int aGrandir;         ///< Anneaux restant à gagner : la queue reste en place tant qu'il en reste
+    tChemin chemin;       ///< Détour conservé entre les tours
+    tPlanificateur planificateur; ///< Détour réparé d'un tour à l'autre (option --detours-incrementaux)
+    int numeroTete;       ///< Numéro (voir tPassage) de la tête, la queue ayant le numéro numeroTete - taille + 1
+    int rangPomme;        ///< Rang dans l'itinéraire de la pomme visée : 0 pour la pomme présente (voir repartirPommes())
+    int numeroPlan;       ///< Numéro du plan en cours, qui valide ses réservations (voir tReservation)
+    int directionImposee; ///< Coup choisi par l'agent MCTS ou alpha-bêta pour le prochain tour, AUCUNE_DIRECTION sinon
+    int nbPommes;         ///< Nombre de pommes mangées par le serpent
+} tSerpent;
+
+/**
+ * Dernier anneau posé sur une case. Chaque nouvelle tête d'un serpent prend le
+ * numéro qui suit celui de la précédente : la queue part toujours avec le plus
+ * petit numéro, si bien que le numéro d'un anneau dit dans combien de tours sa
+ * case sera libérée, sans qu'aucune case ne soit mise à jour quand le serpent
+ * avance ou grandit (voir toursAvantLiberation()).
+ */
+typedef struct {
+    int serpent;  ///< Indice du serpent dans l'arène
+    int numero;   ///< Numéro de l'anneau
+} tPassage;
+
+/**
+ * Réservation d'une case par le plan d'un serpent : sa tête doit y entrer au
+ * tour indiqué (voir reserverPlan()).
+ *
+ * Une case où entre une tête reste occupée par le corps pendant autant de
+ * tours que le serpent a d'anneaux, en général plus que FENETRE_RESERVATIONS :
+ * deux réservations de la même case dans la fenêtre se chevaucheraient
+ * presque toujours. Chaque case ne porte donc qu'une réservation, lue en temps
+ * constant. Une réservation n'est valable que si plan est encore le plan en
+ * cours du serpent : en se replanifiant, un serpent périme toutes ses anciennes
+ * réservations d'un coup, sans les effacer.
+ */
+typedef struct {
+    int tour;     ///< Tour (voir tOccupation) où la tête doit entrer dans la case
+    int serpent;  ///< Indice du serpent, -1 si la case n'a jamais été réservée
+    int plan;     ///< Numéro du plan qui a posé la réservation
+} tReservation;
+
+/**
+ * Occupation partagée par tous les serpents. Des anneaux peuvent se superposer
+ * (un serpent bloqué reste sur place) : le nombre d'anneaux de chaque case est
+ * conservé, et la couche des corps indique les cases où il est non nul.
+ */
+typedef struct {
+    tMemoireTuiles anneaux;   ///< Nombre d'anneaux (int) de chaque case, 0 pour une case libre
+    tCouche corps;            ///< Cases qui contiennent au moins un anneau
+    tJournal journal;         ///< Cases de la couche des corps qui ont changé
+    tMemoireTuiles passages;  ///< tPassage de chaque case, valable tant qu'elle est occupée
+    tSerpent *lesSerpents;    ///< Serpents de l'arène, dont passages donne les indices
+    tMemoireTuiles reservations; ///< tReservation de chaque case (option --reservations)
+    tRecherche recherche;     ///< Mémoire des recherches de détour (voir calculerChemin()), partagée par les serpents qui jouent à tour de rôle
+    int tour;                 ///< Numéro du tour en cours
+} tOccupation;
+
+// Déplacements élémentaires : bas, haut, droite, gauche
+const int DEPLACEMENT_X[NB_DIRECTIONS] = {0, 0, 1, -1};
+const int DEPLACEMENT_Y[NB_DIRECTIONS] = {1, -1, 0, 0};
+
+/**
+ * Bilan d'une partie.
+ */
+typedef struct {
+    int nbDeplacements;  ///< Nombre de tours joués
+    int nbPommesMangees; ///< Nombre de pommes mangées
+    bool abandonnee;     ///< Vrai si la partie a été arrêtée au bout de MAX_DEPLACEMENTS tours
+    int nbRetards;       ///< Nombre de tours terminés après leur échéance
+    int nbImagesSautees; ///< Nombre de tours joués sans rafraîchir l'écran pour rattraper un retard
+    int nbPommesPremier; ///< Nombre de pommes mangées par le premier serpent (l'agent avec l'option --mcts ou --alphabeta)
+} tPartie;
+
+/**
+ * Durées de décision relevées à chaque tour pendant un benchmark.
+ */
+typedef struct {
+    long *lesDurees; ///< Durées en nanosecondes, dans l'ordre des tours
+    int nbDurees;    ///< Nombre de durées relevées
+    int capacite;    ///< Nombre de durées que peut contenir lesDurees
+} tLatences;
+
+/**
+ * Cadence des tours de jeu.
+ */
+typedef struct {
+    struct timespec echeance; ///< Date absolue (CLOCK_MONOTONIC) de la fin du tour en cours
+    int nbRetards;            ///< Nombre de tours terminés après leur échéance
+} tCadence;
+
+/**
+ * Générateur pseudo-aléatoire xoshiro256** propre à un tirage. Sa suite ne
+ * dépend que de la graine, pas de la bibliothèque C (contrairement à
+ * rand_r()) : une graine donne la même partie sur toutes les machines.
+ */
+typedef struct {
+    uint64_t etat[4]; ///< État du générateur, jamais entièrement nul
+} tAleatoire;
+
+/**
+ * Partie à deux serpents telle que la simule l'agent MCTS, tenue dans une
+ * ligne de cache pour être copiée à chaque simulation sans allocation. Le
+ * plateau, les pommes et leurs champs de distances ne changent pas pendant la
+ * réflexion et restent partagés (voir tContexteMcts).
+ *
+ * Un corps est décrit par sa tête et, pour chaque anneau, la direction de
+ * l'anneau suivant : 2 bits par anneau, l'anneau k dans corps[s][k / 32]. Le
+ * serpent avance en décalant ces bits ; seuls ses ANNEAUX_MCTS premiers
+ * anneaux sont retenus.
+ */
+typedef struct {
+    uint64_t corps[2][2];  ///< Directions de chaque anneau vers le suivant, de la tête vers la queue
+    uint16_t teteX[2];     ///< Position X des têtes
+    uint16_t teteY[2];     ///< Position Y des têtes
+    uint16_t aGrandir[2];  ///< Anneaux restant à gagner par chaque serpent
+    uint8_t taille[2];     ///< Nombre d'anneaux retenus de chaque serpent
+    uint8_t pommes[2];     ///< Pommes mangées par chaque serpent depuis la racine
+    uint8_t indexPomme;    ///< Indice de la pomme présente
+    uint8_t joueur;        ///< Serpent qui joue le prochain coup
+    uint8_t profondeur;    ///< Coups joués depuis la racine
+} tEtatMcts;
+
+/**
+ * Nœud d'un arbre de l'agent MCTS. Les fils d'un nœud sont contigus ; l'état
+ * d'un nœud n'est pas conservé mais rejoué depuis la racine.
+ */
+typedef struct {
+    int premierFils;   ///< Indice du premier fils, -1 tant que le nœud n'est pas développé
+    int visites;       ///< Nombre de simulations passées par le nœud
+    float gains;       ///< Somme de leurs résultats pour le serpent qui a joué le coup du nœud
+    int8_t nbFils;     ///< Nombre de fils
+    int8_t direction;  ///< Coup qui mène au nœud, AUCUNE_DIRECTION pour un serpent bloqué
+} tNoeudMcts;
+
+/**
+ * Données partagées en lecture seule par les fils de l'agent MCTS, ou de
+ * l'agent alpha-bêta, pendant une réflexion.
+ */
+typedef struct {
+    tEtatMcts racine;          ///< État de la partie au début du tour
+    struct timespec echeance;  ///< Date absolue (CLOCK_MONOTONIC) de la fin de la réflexion
+    tPlateau *plateau;         ///< Le plateau de jeu
+    tItineraire *itineraire;   ///< Champs de distances de la pomme présente et des suivantes
+    int *lesPommesX;           ///< Positions X des pommes
+    int *lesPommesY;           ///< Positions Y des pommes
+} tContexteMcts;
+
+/**
+ * Arbre de recherche d'un fil de l'agent MCTS. Chaque fil développe son propre
+ * arbre depuis la même racine (parallélisme à la racine) : aucun verrou n'est
+ * nécessaire, et les visites des fils de la racine sont additionnées à la fin.
+ */
+typedef struct {
+    pthread_t fil;             ///< Fil d'exécution qui développe l'arbre
+    tNoeudMcts *lesNoeuds;     ///< NOEUDS_MCTS nœuds alloués une fois pour toute la partie
+    int nbNoeuds;              ///< Nombre de nœuds de l'arbre en cours
+    tAleatoire aleatoire;      ///< Générateur propre au fil
+    tContexteMcts *contexte;   ///< Réflexion en cours
+} tArbreMcts;
+
+/**
+ * Agent MCTS qui joue le premier serpent d'une partie à deux (option --mcts).
+ */
+typedef struct {
+    tContexteMcts contexte;    ///< Réflexion en cours
+    tArbreMcts *lesArbres;     ///< Un arbre par fil d'exécution
+    int nbArbres;              ///< Nombre de fils d'exécution
+} tAgentMcts;
+
+/**
+ * Entrée de la table de transposition de l'agent alpha-bêta, lue et écrite
+ * sans verrou par tous ses fils. Le premier mot vaut la clé de la position
+ * XOR le second : une entrée dont un fil n'a écrit qu'un mot pendant qu'un
+ * autre la lisait ne correspond plus à aucune clé et est ignorée.
+ */
+typedef struct {
+    _Atomic uint64_t verrou;   ///< Clé Zobrist de la position XOR donnees
+    _Atomic uint64_t donnees;  ///< Score, profondeur, borne et meilleur coup (voir rangerTransposition())
+} tEntreeTransposition;
+
+/**
+ * Fil d'exécution de l'agent alpha-bêta. Le premier fil donne le coup joué ;
+ * les suivants approfondissent la même racine en décalé et ne servent qu'à
+ * remplir la table de transposition partagée.
+ */
+typedef struct {
+    pthread_t fil;             ///< Fil d'exécution (inutilisé pour le premier, qui tourne dans le fil du jeu)
+    struct sAgentAlphaBeta *agent; ///< Agent du fil
+    int premiereProfondeur;    ///< Profondeur de la première itération
+    long nbNoeuds;             ///< Nœuds explorés pendant la réflexion en cours
+    bool interrompue;          ///< Vrai une fois l'échéance passée
+    int meilleurCoup;          ///< Meilleur coup de la racine trouvé jusqu'ici
+} tChercheurAlphaBeta;
+
+/**
+ * Agent alpha-bêta qui joue le premier serpent d'une partie à deux (option
+ * --alphabeta).
+ */
+typedef struct sAgentAlphaBeta {
+    tContexteMcts contexte;            ///< Réflexion en cours (état compact de la racine et échéance)
+    uint64_t cleRacine;                ///< Clé Zobrist de la racine
+    tEntreeTransposition *lesEntrees;  ///< Table de transposition, ENTREES_TRANSPOSITION entrées conservées toute la partie
+    tChercheurAlphaBeta *lesChercheurs; ///< Un chercheur par fil d'exécution
+    int nbChercheurs;                  ///< Nombre de fils d'exécution
+} tAgentAlphaBeta;
+
+bool modeSansAffichage = false; ///< Vrai si la partie est simulée sans terminal (ni affichage, ni attente, ni clavier)
+struct termios terminalInitial;  ///< Réglages du terminal à restaurer en fin de partie
+bool modeBrutActif = false;      ///< Vrai tant que le terminal est en mode brut
+bool modeSautImages = false;     ///< Vrai si les tours en retard peuvent être joués sans rafraîchir l'écran
+bool modeDetoursIncrementaux = false; ///< Vrai si les détours sont confiés au planificateur incrémental
+bool modeCooperatif = false;     ///< Vrai si les prochaines pommes sont réparties entre les serpents
+bool modeReservations = false;   ///< Vrai si chaque serpent réserve ses prochains pas et contourne ceux des autres
+bool modeMcts = false;           ///< Vrai si le premier serpent est joué par l'agent MCTS
+int budgetMcts = BUDGET_MCTS;    ///< Temps de réflexion par tour de l'agent MCTS (en millisecondes)
+int nbFilsMcts = NB_FILS_MCTS;   ///< Nombre de fils d'exécution de l'agent MCTS
+bool modeAlphaBeta = false;      ///< Vrai si le premier serpent est joué par l'agent alpha-bêta
+int budgetAlphaBeta = BUDGET_ALPHABETA; ///< Échéance par tour de l'agent alpha-bêta (en millisecondes)
+int nbFilsAlphaBeta = NB_FILS_ALPHABETA; ///< Nombre de fils d'exécution de l'agent alpha-bêta
+int nbSerpents = NB_SERPENTS;    ///< Nombre de serpents dans l'arène
+int croissanceParPomme = CROISSANCE_DEFAUT; ///< Anneaux gagnés par un serpent à chaque pomme mangée
+int largeurPlateau = LARGEUR_PLATEAU; ///< Largeur du plateau de la partie
+int hauteurPlateau = HAUTEUR_PLATEAU; ///< Hauteur du plateau de la partie
+typedef char tEcran[HAUTEUR_ECRAN + 1][LARGEUR_ECRAN + 1];
+
+tEcran ecranCourant;   ///< Tampon arrière : ce qui doit être affiché à la fin du tour
+tEcran ecranAffiche;   ///< Tampon avant : ce que le terminal affiche réellement
 
 // Prototypes des fonctions
-void initPlateau(tPlateau plateau);
-void dessinerPlateau(tPlateau plateau);
+void creerGrille(tGrille *grille, int largeur, int hauteur, char defaut);
+void viderGrille(tGrille *grille);
+void detruireGrille(tGrille *grille);
+char lireCase(tGrille *grille, int x, int y);
+void ecrireCase(tGrille *grille, int x, int y, char valeur);
+void enfiler(tFile *file, int indice);
+int defiler(tFile *file);
+void creerCouche(tCouche *couche, int largeur, int hauteur);
+void detruireCouche(tCouche *couche);
+uint64_t lireMot(tCouche *couche, int x, int y);
+bool lireBit(tCouche *couche, int x, int y);
+void ecrireBit(tCouche *couche, int x, int y, bool valeur);
+void placerPavesParDefaut(int lesPavesX[], int lesPavesY[]);
+void initPlateau(tPlateau *plateau, int lesPavesX[], int lesPavesY[]);
+void dessinerPlateau(tPlateau *plateau);
 void afficher(int x, int y, char car);
 void effacer(int x, int y);
-void dessinerSerpent(int lesX[], int lesY[]);
-bool collision(int x, int y, int lesX[], int lesY[], int lesX_2[], int lesY_2[]);
-void progresser1(int lesX[], int lesY[], int lesX_2[], int lesY_2[], int cibleX, int cibleY, tPlateau plateau, bool *pomme);
-void progresser2(int lesX[], int lesY[], int lesX_2[], int lesY_2[], int cibleX, int cibleY, tPlateau plateau, bool *pomme);
+void rafraichirEcran();
+void dessinerSerpent(tSerpent *serpent);
+void coucherSerpent(tSerpent *serpent, int teteX, int teteY, tOccupation *occupation);
+void agrandirAnneaux(tSerpent *serpent);
+void deplacerAnneau(int x, int y, int delta, tOccupation *occupation);
+bool collision(int x, int y, tOccupation *occupation);
+void noterPassage(int x, int y, tSerpent *serpent, tOccupation *occupation);
+int toursAvantLiberation(int x, int y, tOccupation *occupation);
+bool anneauParti(int x, int y, int serpent, int tour, tPlateau *plateau, tOccupation *occupation);
+bool caseReservee(int x, int y, int serpent, int tour, tOccupation *occupation);
+bool reserverCase(int x, int y, int serpent, int tour, tOccupation *occupation);
+void caseVoisine(int x, int y, int direction, int *voisinX, int *voisinY);
+bool caseObstacle(int x, int y, tPlateau *plateau);
+bool caseLibre(int x, int y, tPlateau *plateau, tOccupation *occupation);
+bool bitObstacle(int x, int y, tPlateau *plateau, tOccupation *occupation);
+int voisinsLibres(int x, int y, tPlateau *plateau, tOccupation *occupation);
+void creerBitboard(tBitboard *bitboard);
+void remplirCasesLibres(tPlateau *plateau, tBitboard *libres);
+void etendreFrontiere(tBitboard *frontiere, int *premiere, int *derniere, tBitboard *libres, tBitboard *atteintes, tBitboard *suivante);
+void calculerDistances(int cibleX, int cibleY, tPlateau *plateau, tParcours *parcours, short distances[]);
+void calculerDistancesParBits(int cibleX, int cibleY, tPlateau *plateau, tParcours *parcours, short distances[]);
+void calculerDistancesParFile(int cibleX, int cibleY, tPlateau *plateau, tParcours *parcours, short distances[]);
+void detruireParcours(tParcours *parcours);
+void creerMemoireTuiles(tMemoireTuiles *memoire, size_t tailleCase, unsigned char octetVide);
+void nouvelleGeneration(tMemoireTuiles *memoire);
+void *caseMemoire(tMemoireTuiles *memoire, int x, int y);
+bool caseConnue(tMemoireTuiles *memoire, int x, int y);
+void detruireMemoireTuiles(tMemoireTuiles *memoire);
+void noterChangement(tJournal *journal, int indice);
+void oublierChangements(tJournal *journal, long premierConserve);
+void preparerRecherche(tRecherche *recherche);
+void detruireRecherche(tRecherche *recherche);
+bool noeudPrioritaire(tRecherche *recherche, int noeudA, int noeudB);
+int ajouterNoeud(tRecherche *recherche, int x, int y, int cout, int estimation, int parent, int direction);
+int extraireNoeud(tRecherche *recherche);
+bool caseFranchissable(int x, int y, int tour, int serpent, tPlateau *plateau, tOccupation *occupation);
+bool casePortail(int x, int y);
+bool procheDuCorps(int x, int y, int serpent, tOccupation *occupation);
+bool voisinForce(int x, int y, int direction, int vertical, int cout, int serpent, tPlateau *plateau, tOccupation *occupation);
+int casesSansEvenement(int x, int y, int direction, int cibleX, int cibleY, tPlateau *plateau, tOccupation *occupation);
+int sauter(int x, int y, int direction, int cout, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation, int *sautX, int *sautY);
+int chercherParSauts(tRecherche *recherche, int departX, int departY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation);
+int chercherCaseParCase(tRecherche *recherche, int departX, int departY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation, bool *trouve);
+bool calculerChemin(int departX, int departY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation, tChemin *chemin);
+bool cheminUtilisable(tChemin *chemin, int teteX, int teteY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation);
+bool casePraticable(tPlanificateur *planificateur, int x, int y, tPlateau *plateau, tOccupation *occupation);
+void empilerCase(tPlanificateur *planificateur, int x, int y);
+tEntree depilerCase(tPlanificateur *planificateur);
+bool entreePrioritaire(tEntree a, tEntree b);
+void reviserCase(tPlanificateur *planificateur, int x, int y, tPlateau *plateau, tOccupation *occupation);
+void signalerChangement(tPlanificateur *planificateur, int x, int y, tPlateau *plateau, tOccupation *occupation);
+void initialiserPlanificateur(tPlanificateur *planificateur, int departX, int departY, int cibleX, int cibleY, tOccupation *occupation);
+void deplacerDepart(tPlanificateur *planificateur, int departX, int departY, tPlateau *plateau, tOccupation *occupation);
+void calculerPlan(tPlanificateur *planificateur, tPlateau *plateau, tOccupation *occupation);
+bool pasSuivant(tPlanificateur *planificateur, tPlateau *plateau, tOccupation *occupation, int *prochainX, int *prochainY);
+void detruirePlanificateur(tPlanificateur *planificateur);
+void planifierDetour(tSerpent *serpent, int teteX, int teteY, int cibleX, int cibleY, bool rapproche, tPlateau *plateau, tOccupation *occupation, int *prochainX, int *prochainY);
+int placerSerpents(tSerpent lesSerpents[], int nbSerpents, tPlateau *plateau, tOccupation *occupation);
+void progresser(tSerpent *serpent, tOccupation *occupation, tItineraire *itineraire, int cibleX, int cibleY, tPlateau *plateau, bool *pomme);
+bool choisirVoisin(tSerpent *serpent, int x, int y, int tour, tItineraire *itineraire, tPlateau *plateau, tOccupation *occupation, int *prochainX, int *prochainY);
+void reserverPlan(tSerpent *serpent, tItineraire *itineraire, int cibleX, int cibleY, tPlateau *plateau, tOccupation *occupation);
+void creerAgentMcts(tAgentMcts *agent, int nbFils);
+void detruireAgentMcts(tAgentMcts *agent);
+void lireEtatMcts(tEtatMcts *etat, tSerpent lesSerpents[], int indexPomme);
+int voisinsOccupesMcts(const tEtatMcts *etat, int serpent, int nbAnneaux, const int lesVoisinsX[], const int lesVoisinsY[]);
+int coupsMcts(const tEtatMcts *etat, tPlateau *plateau, int lesCoups[]);
+void jouerCoupMcts(tEtatMcts *etat, int direction, tContexteMcts *contexte);
+bool finMcts(const tEtatMcts *etat, tContexteMcts *contexte);
+double simulerMcts(tEtatMcts *etat, tContexteMcts *contexte, tAleatoire *aleatoire);
+int choisirFilsMcts(tArbreMcts *arbre, int noeud);
+void *explorerMcts(void *arbre);
+int deciderMcts(tAgentMcts *agent, tSerpent lesSerpents[], int indexPomme, tPlateau *plateau, tItineraire *itineraire, int lesPommesX[], int lesPommesY[]);
+void creerAgentAlphaBeta(tAgentAlphaBeta *agent, int nbFils);
+void detruireAgentAlphaBeta(tAgentAlphaBeta *agent);
+uint64_t cleZobrist(int element, int valeur);
+void anneauMcts(const tEtatMcts *etat, int serpent, int k, int *x, int *y);
+uint64_t clePosition(const tEtatMcts *etat);
+uint64_t jouerCoupAlphaBeta(tEtatMcts *etat, uint64_t cle, int direction, tContexteMcts *contexte);
+bool feuilleAlphaBeta(const tEtatMcts *etat, tContexteMcts *contexte);
+int evaluerAlphaBeta(const tEtatMcts *etat, tContexteMcts *contexte);
+void ordonnerCoups(const tEtatMcts *etat, tContexteMcts *contexte, int lesCoups[], int nbCoups, int coupPrefere);
+bool lireTransposition(tAgentAlphaBeta *agent, uint64_t cle, int *score, int *profondeur, int *borne, int *coup);
+void rangerTransposition(tAgentAlphaBeta *agent, uint64_t cle, int score, int profondeur, int borne, int coup);
+int chercherAlphaBeta(tChercheurAlphaBeta *chercheur, const tEtatMcts *etat, uint64_t cle, int profondeur, int alpha, int beta, int *meilleurCoup);
+void *approfondirAlphaBeta(void *chercheur);
+int deciderAlphaBeta(tAgentAlphaBeta *agent, tSerpent lesSerpents[], int indexPomme, tPlateau *plateau, tItineraire *itineraire, int lesPommesX[], int lesPommesY[]);
+bool mieuxPlacee(tItineraire *itineraire, int rang, int caseA, int caseB, int distance, int longueur);
+void jouerTour(tSerpent lesSerpents[], int nbSerpents, tOccupation *occupation, tPlateau *plateau, int lesPommesX[], int lesPommesY[], int *indexPomme, tItineraire *itineraire, tAgentMcts *agentMcts, tAgentAlphaBeta *agentAlphaBeta);
+void avancerItineraire(tItineraire *itineraire, int indexPomme, int lesPommesX[], int lesPommesY[], tPlateau *plateau);
+void repartirPommes(tSerpent lesSerpents[], int nbSerpents, tItineraire *itineraire, int lesPommesX[], int lesPommesY[]);
 void gotoxy(int x, int y);
 void finProgramme(int nbDeplacements, clock_t tempsDebut, clock_t tempsFin);
-int kbhit();
-void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY, int *nouvelleX, int *nouvelleY, bool *utilisePortail);
+tPartie jouerPartie(int lesPavesX[], int lesPavesY[], int lesPommesX[], int lesPommesY[], int maxDeplacements, tLatences *latences);
+void lancerBenchmark(int nbParties, unsigned int graine, bool aleatoire, int lesPavesX[], int lesPavesY[], int lesPommesX[], int lesPommesY[], const char *fichierCsv);
+void initialiserAleatoire(tAleatoire *aleatoire, uint64_t graine);
+uint64_t tirerAleatoire(tAleatoire *aleatoire);
+int tirerEntier(tAleatoire *aleatoire, int borne);
+uint64_t graineFlux(unsigned int graine, int flux);
+short *distancesDepuisDepart(tPlateau *plateau);
+void genererPaves(unsigned int graine, int lesPavesX[], int lesPavesY[]);
+void genererPommes(unsigned int graine, int lesPavesX[], int lesPavesY[], int lesPommesX[], int lesPommesY[]);
+void enregistrerLatence(tLatences *latences, long duree);
+long dureeNanosecondes(struct timespec debut, struct timespec fin);
+int comparerDurees(const void *a, const void *b);
+void calculerPercentiles(long lesDurees[], int nbDurees, long *p50, long *p99, long *max);
+void activerModeBrut();
+void restaurerTerminal();
+void interrompreProgramme(int numeroSignal);
+bool lireTouche(char *touche);
+void demarrerCadence(tCadence *cadence);
+bool attendreTourSuivant(tCadence *cadence);
+int calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY, int *nouvelleX, int *nouvelleY, bool *utilisePortail);
 
 /**************************************
 *                                     *
@@ -56,73 +711,488 @@ void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY
 /**
  * @brief Programme principal du jeu.
  *
- * Cette fonction gare le jeu, le plateau, le serpent, les pommes, et le mouvement du serpent.
- * Elle gare également l'affichage du nombre de déplacements et du temps d'exécution du jeu.
+ * Cette fonction lit les options de lancement puis joue une partie avec les
+ * pommes prévues. Elle gare également l'affichage du nombre de déplacements et du temps d'exécution du jeu.
+ *
+ * Lancé avec l'option --sans-affichage, le jeu est simulé sans affichage ni
+ * temporisation et seules les statistiques de fin sont affichées.
+ *
+ * L'option --serpents=N lance N serpents dans l'arène au lieu de deux.
+ * L'option --croissance=N fait gagner N anneaux à un serpent pour chaque
+ * pomme qu'il mange (0 par défaut : les serpents gardent leur taille).
+ * L'option --plateau=LARGEURxHAUTEUR change les dimensions du plateau ; les
+ * pommes prévues n'ayant de sens que sur le plateau d'origine, elles sont
+ * alors tirées au hasard avec la graine (voir genererPommes()).
+ * Avec --disposition=aleatoire, les pavés puis les pommes sont tirés à partir
+ * de la graine --graine=G (voir genererPaves()) : une graine donne toujours
+ * la même partie.
  *
+ * Avec l'option --sauter-images, un tour qui suit un tour en retard est joué
+ * sans rafraîchir l'écran, pour que la partie garde sa cadence sous la charge.
+ * Avec l'option --detours-incrementaux, un serpent bloqué est guidé jusqu'à la
+ * pomme par un planificateur réparé d'un tour à l'autre (voir planifierDetour()).
+ * Avec l'option --cooperatif, les serpents se répartissent les prochaines
+ * pommes au lieu de tous courir vers la même (voir repartirPommes()). Avec
+ * l'option --reservations, chaque serpent réserve ses prochains pas et les
+ * autres planifient autour (voir reserverPlan()). Avec l'option --mcts, dans
+ * une partie à deux serpents, le premier est joué par un agent MCTS qui
+ * réfléchit --budget-mcts=MS millisecondes par tour sur --fils-mcts=N fils
+ * d'exécution (voir deciderMcts()). Avec l'option --alphabeta, il est joué
+ * par une recherche alpha-bêta qui rend son coup avant --budget-alphabeta=MS
+ * millisecondes, sur --fils-alphabeta=N fils (voir deciderAlphaBeta()).
+ *
+ * Lancé avec l'option --benchmark, le programme enchaîne sans affichage
+ * plusieurs parties et affiche leurs statistiques (voir lancerBenchmark()).
+ * Les options --parties=N, --graine=G, --disposition=fixe|aleatoire et
+ * --csv=fichier règlent la série.
+ *
+ * @param argc Nombre d'arguments de la ligne de commande.
+ * @param argv Arguments de la ligne de commande.
  * @return EXIT_SUCCESS si le programme s'est exécuté avec succas.
  */
-int main() {
-    tPlateau lePlateau;
-    int lesX[TAILLE], lesY[TAILLE];
-    int lesX_2[TAILLE], lesY_2[TAILLE];
+int main(int argc, char *argv[]) {
     int lesPommesX[NB_POMMES] = {40, 75, 78, 2, 9, 78, 74, 2, 72, 5};
-	int lesPommesY[NB_POMMES] = {20, 38, 2, 2, 5, 38, 32, 38, 32, 2};
-    int nbDeplacements = 0;
+    int lesPommesY[NB_POMMES] = {20, 38, 2, 2, 5, 38, 32, 38, 32, 2};
+    int lesPavesX[NB_PAVES], lesPavesY[NB_PAVES];
+    bool modeBenchmark = false;
+    int nbParties = NB_PARTIES_DEFAUT;
+    unsigned int graine = 1;
+    bool aleatoire = false;
+    const char *fichierCsv = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], OPTION_SANS_AFFICHAGE) == 0) {
+            modeSansAffichage = true;
+        } else if (strncmp(argv[i], OPTION_PLATEAU, strlen(OPTION_PLATEAU)) == 0) {
+            if (sscanf(argv[i] + strlen(OPTION_PLATEAU), "%dx%d", &largeurPlateau, &hauteurPlateau) != 2) {
+                largeurPlateau = hauteurPlateau = 0;
+            }
+        } else if (strncmp(argv[i], OPTION_SERPENTS, strlen(OPTION_SERPENTS)) == 0) {
+            nbSerpents = atoi(argv[i] + strlen(OPTION_SERPENTS));
+        } else if (strncmp(argv[i], OPTION_CROISSANCE, strlen(OPTION_CROISSANCE)) == 0) {
+            croissanceParPomme = atoi(argv[i] + strlen(OPTION_CROISSANCE));
+        } else if (strcmp(argv[i], OPTION_SAUT_IMAGES) == 0) {
+            modeSautImages = true;
+        } else if (strcmp(argv[i], OPTION_DETOURS_INCREMENTAUX) == 0) {
+            modeDetoursIncrementaux = true;
+        } else if (strcmp(argv[i], OPTION_COOPERATIF) == 0) {
+            modeCooperatif = true;
+        } else if (strcmp(argv[i], OPTION_RESERVATIONS) == 0) {
+            modeReservations = true;
+        } else if (strcmp(argv[i], OPTION_MCTS) == 0) {
+            modeMcts = true;
+        } else if (strncmp(argv[i], OPTION_BUDGET_MCTS, strlen(OPTION_BUDGET_MCTS)) == 0) {
+            budgetMcts = atoi(argv[i] + strlen(OPTION_BUDGET_MCTS));
+        } else if (strncmp(argv[i], OPTION_FILS_MCTS, strlen(OPTION_FILS_MCTS)) == 0) {
+            nbFilsMcts = atoi(argv[i] + strlen(OPTION_FILS_MCTS));
+        } else if (strcmp(argv[i], OPTION_ALPHABETA) == 0) {
+            modeAlphaBeta = true;
+        } else if (strncmp(argv[i], OPTION_BUDGET_ALPHABETA, strlen(OPTION_BUDGET_ALPHABETA)) == 0) {
+            budgetAlphaBeta = atoi(argv[i] + strlen(OPTION_BUDGET_ALPHABETA));
+        } else if (strncmp(argv[i], OPTION_FILS_ALPHABETA, strlen(OPTION_FILS_ALPHABETA)) == 0) {
+            nbFilsAlphaBeta = atoi(argv[i] + strlen(OPTION_FILS_ALPHABETA));
+        } else if (strcmp(argv[i], OPTION_BENCHMARK) == 0) {
+            modeBenchmark = true;
+        } else if (strncmp(argv[i], OPTION_PARTIES, strlen(OPTION_PARTIES)) == 0) {
+            nbParties = atoi(argv[i] + strlen(OPTION_PARTIES));
+        } else if (strncmp(argv[i], OPTION_GRAINE, strlen(OPTION_GRAINE)) == 0) {
+            graine = (unsigned int)strtoul(argv[i] + strlen(OPTION_GRAINE), NULL, 10);
+        } else if (strncmp(argv[i], OPTION_DISPOSITION, strlen(OPTION_DISPOSITION)) == 0) {
+            aleatoire = strcmp(argv[i] + strlen(OPTION_DISPOSITION), DISPOSITION_ALEATOIRE) == 0;
+        } else if (strncmp(argv[i], OPTION_CSV, strlen(OPTION_CSV)) == 0) {
+            fichierCsv = argv[i] + strlen(OPTION_CSV);
+        }
+    }
+
+    if (nbSerpents < 1 || nbSerpents > NB_SERPENTS_MAX) {
+        fprintf(stderr, "Le nombre de serpents doit être compris entre 1 et %d\n", NB_SERPENTS_MAX);
+        return EXIT_FAILURE;
+    }
+    if (croissanceParPomme < 0) {
+        fprintf(stderr, "La croissance par pomme ne peut pas être négative\n");
+        return EXIT_FAILURE;
+    }
+    if (modeMcts && modeAlphaBeta) {
+        fprintf(stderr, "Le premier serpent ne peut être joué que par un seul agent\n");
+        return EXIT_FAILURE;
+    }
+    if ((modeMcts || modeAlphaBeta) && modeCooperatif) {
+        // Les agents jouent pour eux seuls : la pomme suivante promise au second serpent les empêcherait de manger la présente
+        fprintf(stderr, "Les agents MCTS et alpha-bêta ne jouent pas avec l'option --cooperatif\n");
+        return EXIT_FAILURE;
+    }
+    if ((modeMcts || modeAlphaBeta) && nbSerpents != 2) {
+        fprintf(stderr, "Les agents MCTS et alpha-bêta ne jouent que les parties à deux serpents\n");
+        return EXIT_FAILURE;
+    }
+    if (budgetMcts < 1 || nbFilsMcts < 1 || nbFilsMcts > NB_FILS_MCTS_MAX
+        || budgetAlphaBeta < 1 || nbFilsAlphaBeta < 1 || nbFilsAlphaBeta > NB_FILS_MCTS_MAX) {
+        fprintf(stderr, "Les agents demandent au moins 1 ms de réflexion et entre 1 et %d fils d'exécution\n", NB_FILS_MCTS_MAX);
+        return EXIT_FAILURE;
+    }
+
+    if (largeurPlateau < LARGEUR_MIN || largeurPlateau > DIMENSION_MAX
+        || hauteurPlateau < HAUTEUR_MIN || hauteurPlateau > DIMENSION_MAX) {
+        fprintf(stderr, "Le plateau doit mesurer entre %dx%d et %dx%d cases\n", LARGEUR_MIN, HAUTEUR_MIN, DIMENSION_MAX, DIMENSION_MAX);
+        return EXIT_FAILURE;
+    }
+    placerPavesParDefaut(lesPavesX, lesPavesY);
+    if (aleatoire && !modeBenchmark) {
+        genererPaves(graine, lesPavesX, lesPavesY);
+        genererPommes(graine, lesPavesX, lesPavesY, lesPommesX, lesPommesY);
+    } else if (largeurPlateau != LARGEUR_PLATEAU || hauteurPlateau != HAUTEUR_PLATEAU) {
+        genererPommes(graine, lesPavesX, lesPavesY, lesPommesX, lesPommesY);
+    }
+
+    if (modeBenchmark) {
+        lancerBenchmark(nbParties, graine, aleatoire, lesPavesX, lesPavesY, lesPommesX, lesPommesY, fichierCsv);
+        return EXIT_SUCCESS;
+    }
+
+    // Le terminal passe une seule fois en mode brut pour toute la partie
+    if (!modeSansAffichage) {
+        activerModeBrut();
+    }
+
+    clock_t tempsDebut = clock();
+    tPartie partie = jouerPartie(lesPavesX, lesPavesY, lesPommesX, lesPommesY, 0, NULL);
+    clock_t tempsFin = clock();
+    finProgramme(partie.nbDeplacements, tempsDebut, tempsFin);
+    if (!modeSansAffichage) {
+        printf("Tours en retard : %d\n", partie.nbRetards);
+        printf("Images sautées : %d\n", partie.nbImagesSautees);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Joue un tour de l'arène : chaque serpent avance d'une case.
+ *
+ * Les serpents jouent l'un après l'autre et consultent tous la même grille
+ * d'occupation, si bien qu'un tour coûte un déplacement par serpent quel que
+ * soit leur nombre. Dès qu'un serpent mange la pomme, la suivante apparaît et
+ * devient la cible des serpents qui n'ont pas encore joué. Avec l'option
+ * --cooperatif, chaque serpent vise la pomme que lui attribue repartirPommes(),
+ * répartition refaite en début de tour et après chaque pomme mangée. Avec
+ * l'option --mcts ou --alphabeta, le coup du premier serpent est choisi par
+ * l'agent correspondant.
+ *
+ * @param lesSerpents Serpents de l'arène.
+ * @param nbSerpents Nombre de serpents.
+ * @param occupation Grille d'occupation de tous les serpents.
+ * @param plateau Le plateau de jeu.
+ * @param lesPommesX Positions X des pommes.
+ * @param lesPommesY Positions Y des pommes.
+ * @param indexPomme Indice de la pomme visée, avancé à chaque pomme mangée.
+ * @param itineraire Champs de distances de la pomme visée et des suivantes.
+ * @param agentMcts Agent MCTS du premier serpent, NULL sans l'option --mcts.
+ * @param agentAlphaBeta Agent alpha-bêta du premier serpent, NULL sans l'option --alphabeta.
+ */
+void jouerTour(tSerpent lesSerpents[], int nbSerpents, tOccupation *occupation, tPlateau *plateau, int lesPommesX[], int lesPommesY[], int *indexPomme, tItineraire *itineraire, tAgentMcts *agentMcts, tAgentAlphaBeta *agentAlphaBeta) {
+    bool pommeMangee;
+    bool repartir = modeCooperatif;
+    long premierAttendu = occupation->journal.premier + occupation->journal.nbCases;
+
+    // Les changements déjà relus par tous les planificateurs en cours sont oubliés
+    for (int i = 0; i < nbSerpents; i++) {
+        if (lesSerpents[i].planificateur.actif && lesSerpents[i].planificateur.changementsLus < premierAttendu) {
+            premierAttendu = lesSerpents[i].planificateur.changementsLus;
+        }
+    }
+    oublierChangements(&occupation->journal, premierAttendu);
+    occupation->tour++;
+
+    for (int i = 0; i < nbSerpents && *indexPomme < NB_POMMES; i++) {
+        avancerItineraire(itineraire, *indexPomme, lesPommesX, lesPommesY, plateau);
+        if (repartir) {
+            repartirPommes(lesSerpents, nbSerpents, itineraire, lesPommesX, lesPommesY);
+            repartir = false;
+        }
+        if (agentMcts != NULL && i == 0) {
+            lesSerpents[i].directionImposee = deciderMcts(agentMcts, lesSerpents, *indexPomme, plateau, itineraire, lesPommesX, lesPommesY);
+        } else if (agentAlphaBeta != NULL && i == 0) {
+            lesSerpents[i].directionImposee = deciderAlphaBeta(agentAlphaBeta, lesSerpents, *indexPomme, plateau, itineraire, lesPommesX, lesPommesY);
+        }
+        int cible = *indexPomme + lesSerpents[i].rangPomme;
+        progresser(&lesSerpents[i], occupation, itineraire, lesPommesX[cible], lesPommesY[cible], plateau, &pommeMangee);
+
+        if (pommeMangee) {
+            repartir = modeCooperatif;
+            (*indexPomme)++;
+            if (*indexPomme < NB_POMMES) {
+                afficher(lesPommesX[*indexPomme], lesPommesY[*indexPomme], POMME);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Met les champs de distances à jour pour la pomme visée.
+ *
+ * Sans effet tant que la pomme visée ne change pas. Sinon, les champs des
+ * pommes déjà mangées sont réutilisés pour celles qui entrent dans la fenêtre,
+ * seules à être calculées.
+ *
+ * @param itineraire Champs de distances des prochaines pommes.
+ * @param indexPomme Indice de la pomme visée.
+ * @param lesPommesX Positions X des pommes.
+ * @param lesPommesY Positions Y des pommes.
+ * @param plateau Le plateau de jeu.
+ */
+void avancerItineraire(tItineraire *itineraire, int indexPomme, int lesPommesX[], int lesPommesY[], tPlateau *plateau) {
+    int capacite = itineraire->capacite;
+    int decalage = (itineraire->premiere == -1) ? capacite : indexPomme - itineraire->premiere;
+    if (decalage == 0) {
+        return;
+    }
+    if (decalage > capacite) {
+        decalage = capacite;
+    }
+
+    // Les champs des pommes mangées passent en fin de fenêtre
+    short *lesLibres[NB_POMMES_PLANIFIEES];
+    for (int i = 0; i < decalage; i++) {
+        lesLibres[i] = itineraire->lesChamps[i];
+    }
+    for (int i = decalage; i < capacite; i++) {
+        itineraire->lesChamps[i - decalage] = itineraire->lesChamps[i];
+    }
+    for (int i = 0; i < decalage; i++) {
+        itineraire->lesChamps[capacite - decalage + i] = lesLibres[i];
+    }
+
+    itineraire->premiere = indexPomme;
+    itineraire->pommeX = lesPommesX[indexPomme];
+    itineraire->pommeY = lesPommesY[indexPomme];
+    itineraire->nbChamps = (NB_POMMES - indexPomme < capacite) ? NB_POMMES - indexPomme : capacite;
+    for (int i = capacite - decalage; i < itineraire->nbChamps; i++) {
+        calculerDistances(lesPommesX[indexPomme + i], lesPommesY[indexPomme + i], plateau, &itineraire->parcours, itineraire->lesChamps[i]);
+    }
+}
+
+/**
+ * @brief Attribue les pommes de l'itinéraire aux serpents selon leur heure d'arrivée.
+ *
+ * Une pomme n'apparaît que lorsque la précédente est mangée : tant que tous
+ * les serpents courent vers la pomme présente, un seul la mange et les autres
+ * repartent de là où la course les a laissés. Les pommes de l'itinéraire sont
+ * donc attribuées dans l'ordre, chacune au serpent qui l'atteindrait le plus
+ * tôt, en comptant qu'il l'attend sur place si elle n'est pas encore apparue :
+ * son arrivée estimée est la plus grande de sa distance à la pomme (lue dans
+ * le champ de distances, corps ignorés) et de l'heure où la pomme précédente
+ * sera mangée. Le serpent qui mange la pomme précédente peut enchaîner s'il
+ * arrive plus tôt que tous les serpents encore libres ; la pomme n'est alors
+ * attribuée à personne d'autre.
+ *
+ * Un serpent qui n'a reçu aucune pomme vise la pomme présente, comme sans
+ * l'option --cooperatif.
+ *
+ * @param lesSerpents Serpents de l'arène, dont rangPomme est mis à jour.
+ * @param nbSerpents Nombre de serpents.
+ * @param itineraire Champs de distances de la pomme présente et des suivantes.
+ * @param lesPommesX Positions X des pommes.
+ * @param lesPommesY Positions Y des pommes.
+ */
+void repartirPommes(tSerpent lesSerpents[], int nbSerpents, tItineraire *itineraire, int lesPommesX[], int lesPommesY[]) {
+    int porteur = -1;     // Serpent qui mange la pomme précédente
+    int heurePomme = 0;   // Tour (compté depuis maintenant) où la pomme précédente est mangée
+
+    for (int i = 0; i < nbSerpents; i++) {
+        lesSerpents[i].rangPomme = -1;
+    }
+
+    for (int rang = 0; rang < itineraire->nbChamps; rang++) {
+        short *distances = itineraire->lesChamps[rang];
+        int elu = -1;
+        int arriveeMin = INFINI;
+
+        for (int i = 0; i < nbSerpents; i++) {
+            int distance = distances[INDICE_CASE(ANNEAU(&lesSerpents[i], 0).x, ANNEAU(&lesSerpents[i], 0).y)];
+            if (lesSerpents[i].rangPomme != -1 || distance == DISTANCE_INCONNUE) {
+                continue;
+            }
+            int arrivee = (distance > heurePomme) ? distance : heurePomme;
+            if (arrivee < arriveeMin) {
+                arriveeMin = arrivee;
+                elu = i;
+            }
+        }
+
+        // Le porteur enchaîne depuis la case de la pomme qu'il vient de manger
+        if (porteur != -1) {
+            int precedente = itineraire->premiere + rang - 1;
+            int distance = distances[INDICE_CASE(lesPommesX[precedente], lesPommesY[precedente])];
+            if (distance != DISTANCE_INCONNUE && heurePomme + distance <= arriveeMin) {
+                heurePomme += distance;
+                continue;
+            }
+        }
+        if (elu == -1) {
+            break;
+        }
+        lesSerpents[elu].rangPomme = rang;
+        porteur = elu;
+        heurePomme = arriveeMin;
+    }
+
+    for (int i = 0; i < nbSerpents; i++) {
+        if (lesSerpents[i].rangPomme == -1) {
+            lesSerpents[i].rangPomme = 0;
+        }
+    }
+}
+
+
+/**
+ * @brief Joue une partie complète.
+ *
+ * La partie s'arrête quand toutes les pommes sont mangées, quand la touche
+ * STOP est appuyée ou, si maxDeplacements est positif, au bout de
+ * maxDeplacements tours.
+ *
+ * @param lesPavesX Positions X des coins haut gauche des pavés.
+ * @param lesPavesY Positions Y des coins haut gauche des pavés.
+ * @param lesPommesX Positions X des pommes, dans l'ordre où elles apparaissent.
+ * @param lesPommesY Positions Y des pommes, dans l'ordre où elles apparaissent.
+ * @param maxDeplacements Nombre maximal de tours (0 : pas de limite).
+ * @param latences Si non NULL, reçoit la durée de décision de chaque tour.
+ * @return Le bilan de la partie.
+ */
+tPartie jouerPartie(int lesPavesX[], int lesPavesY[], int lesPommesX[], int lesPommesY[], int maxDeplacements, tLatences *latences) {
+    tPlateau lePlateau;
+    tSerpent *lesSerpents;
+    tOccupation occupation;
+    tItineraire itineraire;
+    tAgentMcts agent;
+    tAgentAlphaBeta agentAlphaBeta;
+    tPartie partie = {0, 0, false, 0, 0, 0};
     int indexPomme = 0;
-    bool pommeMangee1 = false;
-    bool pommeMangee2 = false;
     char touche;
+    struct timespec debutDecision, finDecision;
+    tCadence cadence;
+    bool imageSautee = false;
 
-    clock_t tempsDebut = clock();
+    // Les serpents, leurs détours et les champs de distances dépendent des dimensions du plateau : tout est alloué sur le tas
+    lesSerpents = calloc(nbSerpents, sizeof(tSerpent));
+    if (lesSerpents == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    itineraire.premiere = -1;
+    itineraire.nbChamps = 0;
+    itineraire.parcours = (tParcours){0};
+    // Un champ par pomme de la fenêtre, tant qu'ils tiennent dans MEMOIRE_CHAMPS ; toujours celui de la pomme visée
+    itineraire.capacite = (int)(MEMOIRE_CHAMPS / (long)(NB_INDICES_CASES * sizeof(short)));
+    if (itineraire.capacite > NB_POMMES_PLANIFIEES) {
+        itineraire.capacite = NB_POMMES_PLANIFIEES;
+    } else if (itineraire.capacite < 1) {
+        itineraire.capacite = 1;
+    }
+    for (int i = 0; i < itineraire.capacite; i++) {
+        itineraire.lesChamps[i] = malloc(NB_INDICES_CASES * sizeof(short));
+        if (itineraire.lesChamps[i] == NULL) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    for (int i = 0; i < TAILLE; i++) {
-        lesX[i] = POSITION_DEP_X_1 - i;
-        lesY[i] = POSITION_DEP_Y_1;
+    if (modeMcts) {
+        creerAgentMcts(&agent, nbFilsMcts);
+    }
+    if (modeAlphaBeta) {
+        creerAgentAlphaBeta(&agentAlphaBeta, nbFilsAlphaBeta);
     }
 
-    for (int i = 0; i < TAILLE; i++) {
-        lesX_2[i] = POSITION_DEP_X_2 - i;
-        lesY_2[i] = POSITION_DEP_Y_2;
+    initPlateau(&lePlateau, lesPavesX, lesPavesY);
+    // Un serpent bloqué qui grandit empile un anneau par tour sur sa tête : le compte dépasse vite un octet
+    creerMemoireTuiles(&occupation.anneaux, sizeof(int), 0);
+    nouvelleGeneration(&occupation.anneaux);
+    creerCouche(&occupation.corps, largeurPlateau + 1, hauteurPlateau + 1);
+    occupation.journal = (tJournal){NULL, 0, 0, 0};
+    creerMemoireTuiles(&occupation.passages, sizeof(tPassage), 0);
+    nouvelleGeneration(&occupation.passages);
+    creerMemoireTuiles(&occupation.reservations, sizeof(tReservation), 0xFF);
+    nouvelleGeneration(&occupation.reservations);
+    occupation.recherche = (tRecherche){0};
+    occupation.tour = 0;
+    occupation.lesSerpents = lesSerpents;
+    if (placerSerpents(lesSerpents, nbSerpents, &lePlateau, &occupation) < nbSerpents) {
+        fprintf(stderr, "Le plateau ne peut pas accueillir %d serpents\n", nbSerpents);
+        exit(EXIT_FAILURE);
     }
 
-    initPlateau(lePlateau);
-    dessinerPlateau(lePlateau);
+    dessinerPlateau(&lePlateau);
     afficher(lesPommesX[indexPomme], lesPommesY[indexPomme], POMME);
-    dessinerSerpent(lesX, lesY);
-    dessinerSerpent(lesX_2, lesY_2);
+    for (int i = 0; i < nbSerpents; i++) {
+        dessinerSerpent(&lesSerpents[i]);
+    }
+    rafraichirEcran();
 
+    demarrerCadence(&cadence);
     while (indexPomme < NB_POMMES) {
-        if (kbhit()) {
-            touche = getchar();
-            if (touche == STOP) {
-                break;
-            }
+        if (maxDeplacements > 0 && partie.nbDeplacements >= maxDeplacements) {
+            partie.abandonnee = true;
+            break;
+        }
+        if (!modeSansAffichage && lireTouche(&touche) && touche == STOP) {
+            break;
         }
 
-        progresser1(lesX_2, lesY_2, lesX, lesY, lesPommesX[indexPomme], lesPommesY[indexPomme], lePlateau, &pommeMangee1);
-        progresser2(lesX, lesY, lesX_2, lesY_2,lesPommesX[indexPomme], lesPommesY[indexPomme], lePlateau, &pommeMangee2);
-        nbDeplacements++;
-        usleep(ATTENTE);
+        if (latences != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &debutDecision);
+        }
+        jouerTour(lesSerpents, nbSerpents, &occupation, &lePlateau, lesPommesX, lesPommesY, &indexPomme, &itineraire, modeMcts ? &agent : NULL, modeAlphaBeta ? &agentAlphaBeta : NULL);
+        if (latences != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &finDecision);
+            enregistrerLatence(latences, dureeNanosecondes(debutDecision, finDecision));
+        }
+        partie.nbDeplacements++;
 
-        if (pommeMangee1) {
-            indexPomme++;
-            pommeMangee1 = false;
-            if (indexPomme < NB_POMMES) {
-                afficher(lesPommesX[indexPomme], lesPommesY[indexPomme], POMME);
-            }
+        // Une seule écriture par tour pour toutes les cases modifiées, sauf si l'image est sautée pour rattraper un retard
+        if (imageSautee) {
+            partie.nbImagesSautees++;
+        } else {
+            rafraichirEcran();
         }
-        if (pommeMangee2) {
-            indexPomme++;
-            pommeMangee2 = false;
-            if (indexPomme < NB_POMMES) {
-                afficher(lesPommesX[indexPomme], lesPommesY[indexPomme], POMME);
-            }
+        if (!modeSansAffichage) {
+            imageSautee = attendreTourSuivant(&cadence) && modeSautImages;
         }
     }
 
-    clock_t tempsFin = clock();
-    finProgramme(nbDeplacements, tempsDebut, tempsFin);
-    return EXIT_SUCCESS;
+    // La dernière image est toujours affichée
+    rafraichirEcran();
+    partie.nbRetards = cadence.nbRetards;
+
+    partie.nbPommesMangees = indexPomme;
+    partie.nbPommesPremier = lesSerpents[0].nbPommes;
+    for (int i = 0; i < nbSerpents; i++) {
+        free(lesSerpents[i].lesAnneaux);
+        free(lesSerpents[i].chemin.lesX);
+        free(lesSerpents[i].chemin.lesY);
+        detruirePlanificateur(&lesSerpents[i].planificateur);
+    }
+    free(lesSerpents);
+    for (int i = 0; i < itineraire.capacite; i++) {
+        free(itineraire.lesChamps[i]);
+    }
+    detruireParcours(&itineraire.parcours);
+    if (modeMcts) {
+        detruireAgentMcts(&agent);
+    }
+    if (modeAlphaBeta) {
+        detruireAgentAlphaBeta(&agentAlphaBeta);
+    }
+    detruireMemoireTuiles(&occupation.anneaux);
+    detruireCouche(&occupation.corps);
+    free(occupation.journal.lesCases);
+    detruireMemoireTuiles(&occupation.passages);
+    detruireMemoireTuiles(&occupation.reservations);
+    detruireRecherche(&occupation.recherche);
+    detruireCouche(&lePlateau.bordures);
+    detruireCouche(&lePlateau.paves);
+    detruireGrille(&lePlateau.rendu);
+    return partie;
 }
 
 /**********************************
@@ -132,414 +1202,3223 @@ int main() {
 *                                 *
 ********************************* */
 /**
- * @brief Initialise le plateau avec les bordures et les portails.
+ * @brief Crée une grille dont toutes les cases ont la valeur par défaut.
+ *
+ * Seul le tableau des tuiles est alloué : les tuiles le seront à la demande
+ * par ecrireCase().
+ *
+ * @param grille Grille à créer.
+ * @param largeur Nombre de cases en X.
+ * @param hauteur Nombre de cases en Y.
+ * @param defaut Valeur des cases jamais écrites.
+ */
+void creerGrille(tGrille *grille, int largeur, int hauteur, char defaut) {
+    grille->largeur = largeur;
+    grille->hauteur = hauteur;
+    grille->nbTuilesX = (largeur + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    grille->nbTuilesY = (hauteur + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    grille->defaut = defaut;
+    grille->lesTuiles = calloc((size_t)grille->nbTuilesX * grille->nbTuilesY, sizeof(char *));
+    if (grille->lesTuiles == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Remet toutes les cases d'une grille à la valeur par défaut.
+ *
+ * Les tuiles allouées sont libérées : le coût ne dépend que du nombre de
+ * tuiles, pas de la surface de la grille.
+ *
+ * @param grille Grille à vider.
+ */
+void viderGrille(tGrille *grille) {
+    for (int i = 0; i < grille->nbTuilesX * grille->nbTuilesY; i++) {
+        free(grille->lesTuiles[i]);
+        grille->lesTuiles[i] = NULL;
+    }
+}
+
+/**
+ * @brief Libère toute la mémoire d'une grille.
+ *
+ * @param grille Grille à détruire.
+ */
+void detruireGrille(tGrille *grille) {
+    viderGrille(grille);
+    free(grille->lesTuiles);
+    grille->lesTuiles = NULL;
+}
+
+/**
+ * @brief Lit une case d'une grille.
+ *
+ * @param grille La grille.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @return La valeur de la case, ou la valeur par défaut si sa tuile n'est pas allouée.
+ */
+char lireCase(tGrille *grille, int x, int y) {
+    char *tuile = grille->lesTuiles[(y / TAILLE_TUILE) * grille->nbTuilesX + x / TAILLE_TUILE];
+    return (tuile == NULL) ? grille->defaut : tuile[(y % TAILLE_TUILE) * TAILLE_TUILE + x % TAILLE_TUILE];
+}
+
+/**
+ * @brief Écrit une case d'une grille, en allouant sa tuile si nécessaire.
+ *
+ * Écrire la valeur par défaut dans une tuile non allouée ne l'alloue pas.
+ *
+ * @param grille La grille.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param valeur Valeur à écrire.
+ */
+void ecrireCase(tGrille *grille, int x, int y, char valeur) {
+    char **tuile = &grille->lesTuiles[(y / TAILLE_TUILE) * grille->nbTuilesX + x / TAILLE_TUILE];
+    if (*tuile == NULL) {
+        if (valeur == grille->defaut) {
+            return;
+        }
+        *tuile = malloc(TAILLE_TUILE * TAILLE_TUILE);
+        if (*tuile == NULL) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+        memset(*tuile, grille->defaut, TAILLE_TUILE * TAILLE_TUILE);
+    }
+    (*tuile)[(y % TAILLE_TUILE) * TAILLE_TUILE + x % TAILLE_TUILE] = valeur;
+}
+
+/**
+ * @brief Ajoute une case à la fin d'une file.
+ *
+ * @param file La file.
+ * @param indice Indice (INDICE_CASE) de la case.
+ */
+void enfiler(tFile *file, int indice) {
+    if (file->nbCases == file->capacite) {
+        // Agrandit le tableau circulaire en remettant les cases en attente dans l'ordre à partir de 0
+        int capacite = (file->capacite == 0) ? TAILLE_TUILE * TAILLE_TUILE : 2 * file->capacite;
+        int *lesCases = malloc((size_t)capacite * sizeof(int));
+        if (lesCases == NULL) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < file->nbCases; i++) {
+            lesCases[i] = file->lesCases[(file->debut + i) % file->capacite];
+        }
+        free(file->lesCases);
+        file->lesCases = lesCases;
+        file->capacite = capacite;
+        file->debut = 0;
+    }
+    file->lesCases[(file->debut + file->nbCases) % file->capacite] = indice;
+    file->nbCases++;
+}
+
+/**
+ * @brief Retire la première case d'une file non vide.
+ *
+ * @param file La file.
+ * @return Indice (INDICE_CASE) de la case retirée.
+ */
+int defiler(tFile *file) {
+    int indice = file->lesCases[file->debut];
+    file->debut = (file->debut + 1) % file->capacite;
+    file->nbCases--;
+    return indice;
+}
+
+/**
+ * @brief Ajoute une case au journal des changements d'occupation.
+ *
+ * @param journal Le journal.
+ * @param indice Indice (INDICE_CASE) de la case prise ou libérée.
+ */
+void noterChangement(tJournal *journal, int indice) {
+    if (journal->nbCases == journal->capacite) {
+        journal->capacite = (journal->capacite == 0) ? TAILLE_TUILE * TAILLE_TUILE : 2 * journal->capacite;
+        journal->lesCases = realloc(journal->lesCases, (size_t)journal->capacite * sizeof(int));
+        if (journal->lesCases == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    journal->lesCases[journal->nbCases++] = indice;
+}
+
+/**
+ * @brief Oublie les changements qui précèdent un numéro donné.
+ *
+ * @param journal Le journal.
+ * @param premierConserve Numéro du plus ancien changement encore attendu.
+ */
+void oublierChangements(tJournal *journal, long premierConserve) {
+    int nbOublies = (int)(premierConserve - journal->premier);
+    if (nbOublies > 0) {
+        journal->nbCases -= nbOublies;
+        memmove(journal->lesCases, journal->lesCases + nbOublies, (size_t)journal->nbCases * sizeof(int));
+        journal->premier = premierConserve;
+    }
+}
+
+/**
+ * @brief Crée une couche de bits dont toutes les cases sont à 0.
+ *
+ * @param couche Couche à créer.
+ * @param largeur Nombre de cases en X.
+ * @param hauteur Nombre de cases en Y.
+ */
+void creerCouche(tCouche *couche, int largeur, int hauteur) {
+    couche->nbTuilesX = (largeur + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    couche->nbTuilesY = (hauteur + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    couche->lesTuiles = calloc((size_t)couche->nbTuilesX * couche->nbTuilesY, sizeof(uint64_t *));
+    if (couche->lesTuiles == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Libère toute la mémoire d'une couche de bits.
+ *
+ * @param couche Couche à détruire.
+ */
+void detruireCouche(tCouche *couche) {
+    for (int i = 0; i < couche->nbTuilesX * couche->nbTuilesY; i++) {
+        free(couche->lesTuiles[i]);
+    }
+    free(couche->lesTuiles);
+    couche->lesTuiles = NULL;
+}
+
+/**
+ * @brief Lit le mot de 64 bits qui contient une case d'une couche.
+ *
+ * @param couche La couche.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @return Les bits des cases de la rangée y dont la position X a le même
+ * quotient x / TAILLE_TUILE, la case x étant au bit x % TAILLE_TUILE.
+ */
+uint64_t lireMot(tCouche *couche, int x, int y) {
+    uint64_t *tuile = couche->lesTuiles[(y / TAILLE_TUILE) * couche->nbTuilesX + x / TAILLE_TUILE];
+    return (tuile == NULL) ? 0 : tuile[y % TAILLE_TUILE];
+}
+
+/**
+ * @brief Lit le bit d'une case d'une couche.
+ *
+ * @param couche La couche.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @return La valeur du bit de la case.
+ */
+bool lireBit(tCouche *couche, int x, int y) {
+    return (lireMot(couche, x, y) >> (x % TAILLE_TUILE)) & 1;
+}
+
+/**
+ * @brief Écrit le bit d'une case d'une couche, en allouant sa tuile si nécessaire.
+ *
+ * @param couche La couche.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param valeur Valeur du bit.
+ */
+void ecrireBit(tCouche *couche, int x, int y, bool valeur) {
+    uint64_t **tuile = &couche->lesTuiles[(y / TAILLE_TUILE) * couche->nbTuilesX + x / TAILLE_TUILE];
+    uint64_t masque = (uint64_t)1 << (x % TAILLE_TUILE);
+    if (*tuile == NULL) {
+        if (!valeur) {
+            return;
+        }
+        *tuile = calloc(TAILLE_TUILE, sizeof(uint64_t));
+        if (*tuile == NULL) {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (valeur) {
+        (*tuile)[y % TAILLE_TUILE] |= masque;
+    } else {
+        (*tuile)[y % TAILLE_TUILE] &= ~masque;
+    }
+}
+
+/**
+ * @brief Place les pavés de la disposition fixe.
+ *
+ * Les pavés sont placés par rapport aux bords et au centre, aux mêmes
+ * endroits que sur le plateau d'origine lorsque ses dimensions sont celles
+ * par défaut.
+ *
+ * @param lesPavesX Positions X des coins haut gauche des pavés.
+ * @param lesPavesY Positions Y des coins haut gauche des pavés.
+ */
+void placerPavesParDefaut(int lesPavesX[], int lesPavesY[]) {
+    int pavesX[NB_PAVES] = { 4, largeurPlateau - 7, 4, largeurPlateau - 7, largeurPlateau / 2 - 2, largeurPlateau / 2 - 2};
+	int pavesY[NB_PAVES] = { 4, 4, hauteurPlateau - 7, hauteurPlateau - 7, hauteurPlateau / 2 - 6, hauteurPlateau / 2 + 2};
+
+    memcpy(lesPavesX, pavesX, sizeof(pavesX));
+    memcpy(lesPavesY, pavesY, sizeof(pavesY));
+}
+
+/**
+ * @brief Initialise le plateau avec les bordures et les portails.
+ *
+ * Cette fonction crée un plateau de jeu avec des bordures (le caractare '#')
+ * et laisse les zones internes vides (le caractare ' '). Elle supprime aussi
+ * les bordures centrales pour simuler des portails. Chaque obstacle est posé
+ * dans sa couche de bits et dans les caractères affichés.
+ *
+ * @param plateau Plateau à créer.
+ * @param lesPavesX Positions X des coins haut gauche des pavés.
+ * @param lesPavesY Positions Y des coins haut gauche des pavés.
+ */
+void initPlateau(tPlateau *plateau, int lesPavesX[], int lesPavesY[]) {
+    // Les cases intérieures sont vides par défaut : seules les tuiles des bordures et des pavés seront allouées
+    creerCouche(&plateau->bordures, largeurPlateau + 1, hauteurPlateau + 1);
+    creerCouche(&plateau->paves, largeurPlateau + 1, hauteurPlateau + 1);
+    creerGrille(&plateau->rendu, largeurPlateau + 1, hauteurPlateau + 1, VIDE);
+    for (int i = 1; i <= largeurPlateau; i++) {
+        ecrireBit(&plateau->bordures, i, 1, true);
+        ecrireBit(&plateau->bordures, i, hauteurPlateau, true);
+    }
+    for (int j = 1; j <= hauteurPlateau; j++) {
+        ecrireBit(&plateau->bordures, 1, j, true);
+        ecrireBit(&plateau->bordures, largeurPlateau, j, true);
+    }
+
+    ecrireBit(&plateau->bordures, largeurPlateau / 2, 1, false);
+    ecrireBit(&plateau->bordures, largeurPlateau / 2, hauteurPlateau, false);
+    ecrireBit(&plateau->bordures, 1, hauteurPlateau / 2, false);
+    ecrireBit(&plateau->bordures, largeurPlateau, hauteurPlateau / 2, false);
+
+    // définition des pavés
+    for (int indicePave=0; indicePave < NB_PAVES; indicePave++){
+        for (int largeur=0; largeur < TAILLE_PAVE_X; largeur++){
+            for (int hauteur=0; hauteur < TAILLE_PAVE_Y; hauteur ++){
+                ecrireBit(&plateau->paves, lesPavesX[indicePave]+largeur, lesPavesY[indicePave]+hauteur, true);
+            }
+        }
+    }
+
+    // Caractères affichés, déduits des couches
+    for (int j = 1; j <= hauteurPlateau; j++) {
+        for (int i = 1; i <= largeurPlateau; i++) {
+            if (lireBit(&plateau->bordures, i, j)) {
+                ecrireCase(&plateau->rendu, i, j, BORDURE);
+            } else if (lireBit(&plateau->paves, i, j)) {
+                ecrireCase(&plateau->rendu, i, j, PAVE);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Calcule la distance optimale vers une pomme en tenant compte des portails.
+ *
+ * Cette fonction calcule la distance la plus courte entre le serpent et une pomme,
+ * en tenant compte de la possibilité d'utiliser les portails pour se téléporter.
+ *
+ * @param serpentX La position X du serpent.
+ * @param serpentY La position Y du serpent.
+ * @param pommeX La position X de la pomme.
+ * @param pommeY La position Y de la pomme.
+ * @param nouvelleX Pointeur vers la nouvelle position X du serpent.
+ * @param nouvelleY Pointeur vers la nouvelle position Y du serpent.
+ * @param utilisePortail Pointeur vers une variable booléenne indiquant si un portail est à utilisé.
+ * @return La distance estimée, directe ou via le meilleur portail.
+ */
+int calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY, int *nouvelleX, int *nouvelleY, bool *utilisePortail) {
+    // Coordonnées des portails
+    int portailGaucheX = 1, portailGaucheY = hauteurPlateau / 2;
+    int portailDroitX = largeurPlateau, portailDroitY = hauteurPlateau / 2;
+    int portailHautX = largeurPlateau / 2, portailHautY = 1;
+    int portailBasX = largeurPlateau / 2, portailBasY = hauteurPlateau;
+
+    // Distance directe entre le serpent et la pomme
+    int distanceDirecte = abs(pommeX - serpentX) + abs(pommeY - serpentY);
+
+    // Distances via les portails
+    int distanceViaGauche = abs(serpentX - portailGaucheX) + abs(serpentY - portailGaucheY) +
+                            abs(portailDroitX - pommeX) + abs(portailDroitY - pommeY)-1;
+    int distanceViaDroit = abs(serpentX - portailDroitX) + abs(serpentY - portailDroitY) +
+                           abs(portailGaucheX - pommeX) + abs(portailGaucheY - pommeY)+1;
+    int distanceViaHaut = abs(serpentX - portailHautX) + abs(serpentY - portailHautY) +
+                          abs(portailBasX - pommeX) + abs(portailBasY - pommeY)+1;
+    int distanceViaBas = abs(serpentX - portailBasX) + abs(serpentY - portailBasY) +
+                         abs(portailHautX - pommeX) + abs(portailHautY - pommeY)-1;
+
+    // Initialisation de la distance minimale
+    int distanceMin = distanceDirecte;
+    *nouvelleX = pommeX;
+    *nouvelleY = pommeY;
+    *utilisePortail = false;
+
+    // Comparaison avec les distances via les portails
+    if (distanceViaGauche < distanceMin) {
+        distanceMin = distanceViaGauche;
+        *nouvelleX = portailGaucheX-1;  // Se diriger vers le portail gauche
+        *nouvelleY = portailGaucheY;
+        *utilisePortail = true;
+    }
+    if (distanceViaDroit < distanceMin) {
+        distanceMin = distanceViaDroit;
+        *nouvelleX = portailDroitX+1;  // Se diriger vers le portail droit
+        *nouvelleY = portailDroitY;
+        *utilisePortail = true;
+    }
+    if (distanceViaHaut < distanceMin) {
+        distanceMin = distanceViaHaut;
+        *nouvelleX = portailHautX;  // Se diriger vers le portail haut
+        *nouvelleY = portailHautY+1;
+        *utilisePortail = true;
+    }
+    if (distanceViaBas < distanceMin) {
+        distanceMin = distanceViaBas;
+        *nouvelleX = portailBasX;  // Se diriger vers le portail bas
+        *nouvelleY = portailBasY-1;
+        *utilisePortail = true;
+    }
+    return distanceMin;
+}
+
+
+/**
+ * @brief Crée un serpent de TAILLE anneaux couché horizontalement, tête à droite.
+ *
+ * @param serpent Serpent à créer.
+ * @param teteX Position X de la tête.
+ * @param teteY Position Y de la tête (et de tout le corps).
+ * @param occupation Grille d'occupation, complétée par les anneaux du serpent.
+ */
+void coucherSerpent(tSerpent *serpent, int teteX, int teteY, tOccupation *occupation) {
+    serpent->capacite = CAPACITE_ANNEAUX;
+    serpent->lesAnneaux = malloc(serpent->capacite * sizeof(tAnneau));
+    if (serpent->lesAnneaux == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    serpent->indiceTete = 0;
+    serpent->taille = TAILLE;
+    serpent->aGrandir = 0;
+    serpent->directionImposee = AUCUNE_DIRECTION;
+    // Les anneaux sont posés de la queue vers la tête, qui reçoit le numéro 0
+    serpent->numeroTete = -TAILLE;
+    for (int i = TAILLE - 1; i >= 0; i--) {
+        ANNEAU(serpent, i).x = teteX - i;
+        ANNEAU(serpent, i).y = teteY;
+        deplacerAnneau(teteX - i, teteY, 1, occupation);
+        serpent->numeroTete++;
+        noterPassage(teteX - i, teteY, serpent, occupation);
+    }
+}
+
+/**
+ * @brief Double la capacité du tableau des anneaux d'un serpent.
+ *
+ * Les anneaux sont recopiés dans l'ordre, la tête à l'indice 0.
+ *
+ * @param serpent Serpent dont le tableau est plein.
+ */
+void agrandirAnneaux(tSerpent *serpent) {
+    tAnneau *lesAnneaux = malloc(2 * serpent->capacite * sizeof(tAnneau));
+    if (lesAnneaux == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < serpent->taille; i++) {
+        lesAnneaux[i] = ANNEAU(serpent, i);
+    }
+    free(serpent->lesAnneaux);
+    serpent->lesAnneaux = lesAnneaux;
+    serpent->capacite *= 2;
+    serpent->indiceTete = 0;
+}
+
+/**
+ * @brief Ajoute ou retire un anneau d'une case de la grille d'occupation.
+ *
+ * La couche des corps suit le passage du nombre d'anneaux à 0 ou depuis 0,
+ * qui est aussi noté dans le journal des changements.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param delta 1 pour un anneau qui arrive, -1 pour un anneau qui part.
+ * @param occupation Grille d'occupation à mettre à jour.
+ */
+void deplacerAnneau(int x, int y, int delta, tOccupation *occupation) {
+    int *nbAnneaux = caseMemoire(&occupation->anneaux, x, y);
+    *nbAnneaux += delta;
+    if ((*nbAnneaux != 0) != lireBit(&occupation->corps, x, y)) {
+        ecrireBit(&occupation->corps, x, y, *nbAnneaux != 0);
+        noterChangement(&occupation->journal, INDICE_CASE(x, y));
+    }
+}
+
+/**
+ * @brief Place les serpents de l'arène au début de la partie.
+ *
+ * Les deux premiers serpents partent des positions d'origine du jeu, le serpent
+ * du bas jouant le premier comme dans la version à deux serpents. Les
+ * suivants sont couchés horizontalement, tête à droite, sur une ligne sur
+ * deux, dans la première suite de TAILLE cases libres trouvée, en laissant
+ * une case entre deux serpents d'une même ligne.
+ *
+ * @param lesSerpents Serpents à placer.
+ * @param nbSerpents Nombre de serpents.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation, complétée par les serpents placés.
+ * @return Le nombre de serpents placés, inférieur à nbSerpents si le plateau est trop petit.
+ */
+int placerSerpents(tSerpent lesSerpents[], int nbSerpents, tPlateau *plateau, tOccupation *occupation) {
+    int lesDepartsX[2] = {POSITION_DEP_X_2, POSITION_DEP_X_1};
+    int lesDepartsY[2] = {POSITION_DEP_Y_2, POSITION_DEP_Y_1};
+    int nbPlaces = 0;
+
+    for (; nbPlaces < nbSerpents && nbPlaces < 2; nbPlaces++) {
+        coucherSerpent(&lesSerpents[nbPlaces], lesDepartsX[nbPlaces], lesDepartsY[nbPlaces], occupation);
+    }
+
+    for (int y = 3; y < hauteurPlateau && nbPlaces < nbSerpents; y += 2) {
+        int libres = 0;
+        for (int x = 2; x < largeurPlateau && nbPlaces < nbSerpents; x++) {
+            libres = caseLibre(x, y, plateau, occupation) ? libres + 1 : 0;
+            if (libres == TAILLE) {
+                coucherSerpent(&lesSerpents[nbPlaces], x, y, occupation);
+                nbPlaces++;
+                // La case suivante reste libre pour séparer deux serpents
+                x++;
+                libres = 0;
+            }
+        }
+    }
+    return nbPlaces;
+}
+
+// Fonction pour vérifier les collisions avec le corps des serpents : une seule lecture dans la grille d'occupation
+bool collision(int x, int y, tOccupation *occupation) {
+    return lireBit(&occupation->corps, x, y);
+}
+
+/**
+ * @brief Retient que la tête d'un serpent vient d'être posée sur une case.
+ *
+ * Seule la case de la nouvelle tête est écrite : les numéros des autres
+ * anneaux restent valables quand le serpent avance.
+ *
+ * @param x Position X de la tête.
+ * @param y Position Y de la tête.
+ * @param serpent Serpent dont la tête porte le numéro numeroTete.
+ * @param occupation Occupation des serpents.
+ */
+void noterPassage(int x, int y, tSerpent *serpent, tOccupation *occupation) {
+    tPassage *passage = caseMemoire(&occupation->passages, x, y);
+    passage->serpent = (int)(serpent - occupation->lesSerpents);
+    passage->numero = serpent->numeroTete;
+}
+
+/**
+ * @brief Calcule dans combien de tours une case occupée sera libérée.
+ *
+ * Le serpent qui occupe la case libère sa queue à chacun de ses tours, sauf
+ * pendant les aGrandir tours où il grandit : l'anneau de numéro n part au
+ * tour n - numéroQueue + 1 + aGrandir. Les pommes qu'il mangera d'ici là
+ * peuvent retarder ce tour ; l'estimation ne sert qu'à planifier, chaque pas
+ * joué étant vérifié sur l'occupation réelle.
+ *
+ * Le compte vaut pour tous les serpents de l'arène, dans l'ordre où ils
+ * jouent : une case libérée en k tours peut recevoir une tête au tour k + 1
+ * de n'importe quel serpent.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param occupation Occupation des serpents.
+ * @return 0 si la case est libre, sinon le nombre de tours joués par le
+ * serpent qui l'occupe avant qu'elle le soit.
+ */
+int toursAvantLiberation(int x, int y, tOccupation *occupation) {
+    if (!collision(x, y, occupation)) {
+        return 0;
+    }
+    tPassage *passage = caseMemoire(&occupation->passages, x, y);
+    tSerpent *serpent = &occupation->lesSerpents[passage->serpent];
+    int numeroQueue = serpent->numeroTete - serpent->taille + 1;
+    return passage->numero - numeroQueue + 1 + serpent->aGrandir;
+}
+
+/**
+ * @brief Indique si une case occupée par un anneau d'un serpent sera libre
+ * quand sa tête y arrivera.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param serpent Indice du serpent.
+ * @param tour Tour d'arrivée de la tête (1 pour le pas joué maintenant).
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @return true si la case n'est occupée que par un anneau du serpent parti avant ce tour.
+ */
+bool anneauParti(int x, int y, int serpent, int tour, tPlateau *plateau, tOccupation *occupation) {
+    if (caseObstacle(x, y, plateau) || ((tPassage *)caseMemoire(&occupation->passages, x, y))->serpent != serpent) {
+        return false;
+    }
+    return toursAvantLiberation(x, y, occupation) <= tour - 1;
+}
+
+/**
+ * @brief Indique si un autre serpent a réservé une case que la tête occuperait à un tour donné.
+ *
+ * La tête qui entre dans la case au tour d'arrivée y laisse son corps pendant
+ * autant de tours que le serpent a d'anneaux ; la réservation d'un autre
+ * serpent la bloque si les deux séjours se chevauchent. Sans l'option
+ * --reservations, aucune case n'est réservée.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param serpent Indice du serpent qui veut entrer dans la case.
+ * @param tour Tour d'arrivée de la tête (1 pour le pas joué maintenant).
+ * @param occupation Occupation des serpents.
+ * @return true si un plan en cours d'un autre serpent passe par la case pendant le séjour.
+ */
+bool caseReservee(int x, int y, int serpent, int tour, tOccupation *occupation) {
+    // La lecture n'alloue pas de tuile : une tuile jamais réservée ne l'est sûrement pas
+    if (!modeReservations || !caseConnue(&occupation->reservations, x, y)) {
+        return false;
+    }
+    tReservation *reservation = caseMemoire(&occupation->reservations, x, y);
+    if (reservation->serpent == -1 || reservation->serpent == serpent
+        || reservation->plan != occupation->lesSerpents[reservation->serpent].numeroPlan) {
+        return false;
+    }
+    tSerpent *autre = &occupation->lesSerpents[reservation->serpent];
+    tSerpent *lui = &occupation->lesSerpents[serpent];
+    int arrivee = occupation->tour + tour - 1;
+    return reservation->tour < arrivee + lui->taille + lui->aGrandir
+           && arrivee < reservation->tour + autre->taille + autre->aGrandir;
+}
+
+/**
+ * @brief Réserve une case pour le plan en cours d'un serpent.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param serpent Indice du serpent.
+ * @param tour Tour d'arrivée de la tête (1 pour le prochain pas du serpent).
+ * @param occupation Occupation des serpents.
+ * @return false si la case est déjà réservée par un autre serpent, sans la réserver.
+ */
+bool reserverCase(int x, int y, int serpent, int tour, tOccupation *occupation) {
+    if (caseReservee(x, y, serpent, tour, occupation)) {
+        return false;
+    }
+    tReservation *reservation = caseMemoire(&occupation->reservations, x, y);
+    reservation->tour = occupation->tour + tour - 1;
+    reservation->serpent = serpent;
+    reservation->plan = occupation->lesSerpents[serpent].numeroPlan;
+    return true;
+}
+
+/**
+ * @brief Calcule la case voisine dans une direction donnée.
+ *
+ * Les bords du plateau se rejoignent : sortir par un portail (ou par un bord)
+ * fait réapparaître le serpent du côté opposé.
+ *
+ * @param x Position X de départ.
+ * @param y Position Y de départ.
+ * @param direction Indice de la direction dans DEPLACEMENT_X et DEPLACEMENT_Y.
+ * @param voisinX Pointeur vers la position X de la case voisine.
+ * @param voisinY Pointeur vers la position Y de la case voisine.
+ */
+void caseVoisine(int x, int y, int direction, int *voisinX, int *voisinY) {
+    *voisinX = x + DEPLACEMENT_X[direction];
+    *voisinY = y + DEPLACEMENT_Y[direction];
+    if (*voisinX < 1) {
+        *voisinX = largeurPlateau;
+    } else if (*voisinX > largeurPlateau) {
+        *voisinX = 1;
+    }
+    if (*voisinY < 1) {
+        *voisinY = hauteurPlateau;
+    } else if (*voisinY > hauteurPlateau) {
+        *voisinY = 1;
+    }
+}
+
+/**
+ * @brief Indique si une case est un obstacle fixe du plateau.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @return true si la case est une bordure ou un pavé.
+ */
+bool caseObstacle(int x, int y, tPlateau *plateau) {
+    return lireBit(&plateau->bordures, x, y) || lireBit(&plateau->paves, x, y);
+}
+
+/**
+ * @brief Indique si le serpent peut entrer dans une case.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @return true si la case n'est ni une bordure, ni un pavé, ni un anneau.
+ */
+bool caseLibre(int x, int y, tPlateau *plateau, tOccupation *occupation) {
+    return !bitObstacle(x, y, plateau, occupation);
+}
+
+/**
+ * @brief Indique si une case est bloquée, en un seul test sur les trois couches.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @return true si la case est une bordure, un pavé ou un anneau.
+ */
+bool bitObstacle(int x, int y, tPlateau *plateau, tOccupation *occupation) {
+    uint64_t mot = lireMot(&plateau->bordures, x, y) | lireMot(&plateau->paves, x, y) | lireMot(&occupation->corps, x, y);
+    return (mot >> (x % TAILLE_TUILE)) & 1;
+}
+
+/**
+ * @brief Calcule d'un coup quelles cases voisines d'une case sont libres.
+ *
+ * Les trois couches sont réunies mot par mot. Les voisins de gauche et de
+ * droite sont dans le mot de la case elle-même sauf en bord de tuile ou
+ * devant un portail ; seuls ces cas passent par caseVoisine().
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @return Masque de NB_DIRECTIONS bits : le bit d est à 1 si la case voisine
+ * dans la direction d est libre.
+ */
+int voisinsLibres(int x, int y, tPlateau *plateau, tOccupation *occupation) {
+    int bas = (y == hauteurPlateau) ? 1 : y + 1;
+    int haut = (y == 1) ? hauteurPlateau : y - 1;
+    int decalage = x % TAILLE_TUILE;
+    int bloques;
+
+    // Directions 0 et 1 : même colonne, rangées voisines
+    bloques = bitObstacle(x, bas, plateau, occupation) | bitObstacle(x, haut, plateau, occupation) << 1;
+
+    // Directions 2 et 3 : les bits de x + 1 et x - 1 dans le mot de la rangée y
+    if (decalage > 0 && decalage < TAILLE_TUILE - 1 && x > 1 && x < largeurPlateau) {
+        uint64_t rangee = lireMot(&plateau->bordures, x, y) | lireMot(&plateau->paves, x, y) | lireMot(&occupation->corps, x, y);
+        rangee >>= decalage - 1;
+        bloques |= (int)((rangee >> 2) & 1) << 2 | (int)(rangee & 1) << 3;
+    } else {
+        int voisinX, voisinY;
+        caseVoisine(x, y, 2, &voisinX, &voisinY);
+        bloques |= bitObstacle(voisinX, voisinY, plateau, occupation) << 2;
+        caseVoisine(x, y, 3, &voisinX, &voisinY);
+        bloques |= bitObstacle(voisinX, voisinY, plateau, occupation) << 3;
+    }
+    return ~bloques & TOUTES_DIRECTIONS;
+}
+
+/**
+ * @brief Alloue un plateau en bits, toutes ses cases à 0.
+ *
+ * @param bitboard Plateau en bits à créer, aux dimensions du plateau de jeu.
+ */
+void creerBitboard(tBitboard *bitboard) {
+    bitboard->nbMots = largeurPlateau / BITS_PAR_MOT + 1;
+    bitboard->lesMots = calloc((size_t)(hauteurPlateau + 1) * bitboard->nbMots, sizeof(uint64_t));
+    if (bitboard->lesMots == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Met à 1 les cases du plateau qui ne sont ni une bordure ni un pavé.
+ *
+ * Une tuile des couches ayant la largeur d'un mot, chaque mot est obtenu
+ * directement à partir des mots des deux couches. La colonne 0, la rangée 0
+ * et les bits au-delà de largeurPlateau restent à 0.
+ *
+ * @param plateau Le plateau de jeu.
+ * @param libres Plateau en bits à remplir.
+ */
+void remplirCasesLibres(tPlateau *plateau, tBitboard *libres) {
+    int dernierMot = largeurPlateau / BITS_PAR_MOT;
+    uint64_t masqueDernierMot = ~(uint64_t)0 >> (BITS_PAR_MOT - 1 - largeurPlateau % BITS_PAR_MOT);
+
+    for (int mot = 0; mot < libres->nbMots; mot++) {
+        MOT_BITBOARD(libres, 0, mot) = 0;
+    }
+    for (int y = 1; y <= hauteurPlateau; y++) {
+        for (int mot = 0; mot <= dernierMot; mot++) {
+            int x = mot * BITS_PAR_MOT;
+            MOT_BITBOARD(libres, y, mot) = ~(lireMot(&plateau->bordures, x, y) | lireMot(&plateau->paves, x, y));
+        }
+        MOT_BITBOARD(libres, y, 0) &= ~(uint64_t)1;
+        MOT_BITBOARD(libres, y, dernierMot) &= masqueDernierMot;
+    }
+}
+
+/**
+ * @brief Avance d'un pas un parcours en largeur par bits.
+ *
+ * Chaque mot de la frontière est étendu à ses voisins par des décalages (un
+ * bit à gauche et à droite, avec la retenue des mots voisins) et par un OU
+ * avec les mots des rangées du dessus et du dessous. Le résultat est filtré
+ * par les cases libres et non encore atteintes. Les portails sont des
+ * transferts de bits : la case 1 et la case largeurPlateau d'une rangée sont
+ * voisines, comme la rangée 1 et la rangée hauteurPlateau.
+ *
+ * Seules les rangées de la frontière et leurs voisines sont traitées. Les
+ * rangées de suivante en dehors de celles-ci doivent être à 0.
+ *
+ * @param frontiere Cases atteintes au pas précédent.
+ * @param premiere Première rangée non vide de la frontière, mise à jour pour suivante.
+ * @param derniere Dernière rangée non vide de la frontière, mise à jour pour suivante
+ * (premiere > derniere quand le parcours est terminé).
+ * @param libres Cases où le parcours peut entrer.
+ * @param atteintes Cases déjà atteintes, complétées par les nouvelles.
+ * @param suivante Reçoit les cases atteintes à ce pas.
+ */
+void etendreFrontiere(tBitboard *frontiere, int *premiere, int *derniere, tBitboard *libres, tBitboard *atteintes, tBitboard *suivante) {
+    int nbMots = frontiere->nbMots;
+    int dernierMot = largeurPlateau / BITS_PAR_MOT;
+    uint64_t bitDerniereCase = (uint64_t)1 << (largeurPlateau % BITS_PAR_MOT);
+    int debut = (*premiere > 1) ? *premiere - 1 : 1;
+    int fin = (*derniere < hauteurPlateau) ? *derniere + 1 : hauteurPlateau;
+
+    // Une frontière qui touche la rangée 1 ou la dernière passe par le portail du haut ou du bas
+    if (*premiere == 1 || *derniere == hauteurPlateau) {
+        debut = 1;
+        fin = hauteurPlateau;
+    }
+
+    *premiere = hauteurPlateau + 1;
+    *derniere = 0;
+    for (int y = debut; y <= fin; y++) {
+        uint64_t *rangee = &MOT_BITBOARD(frontiere, y, 0);
+        uint64_t *dessus = &MOT_BITBOARD(frontiere, (y > 1) ? y - 1 : hauteurPlateau, 0);
+        uint64_t *dessous = &MOT_BITBOARD(frontiere, (y < hauteurPlateau) ? y + 1 : 1, 0);
+        uint64_t *nouvelles = &MOT_BITBOARD(suivante, y, 0);
+        uint64_t *libresRangee = &MOT_BITBOARD(libres, y, 0);
+        uint64_t *atteintesRangee = &MOT_BITBOARD(atteintes, y, 0);
+        uint64_t nonVide = 0;
+
+        for (int mot = 0; mot < nbMots; mot++) {
+            uint64_t voisins = dessus[mot] | dessous[mot] | rangee[mot] << 1 | rangee[mot] >> 1;
+            if (mot > 0) {
+                voisins |= rangee[mot - 1] >> (BITS_PAR_MOT - 1);
+            }
+            if (mot < nbMots - 1) {
+                voisins |= rangee[mot + 1] << (BITS_PAR_MOT - 1);
+            }
+            nouvelles[mot] = voisins;
+        }
+
+        // Portails gauche et droit
+        if (rangee[0] & 2) {
+            nouvelles[dernierMot] |= bitDerniereCase;
+        }
+        if (rangee[dernierMot] & bitDerniereCase) {
+            nouvelles[0] |= 2;
+        }
+
+        for (int mot = 0; mot < nbMots; mot++) {
+            nouvelles[mot] &= libresRangee[mot] & ~atteintesRangee[mot];
+            atteintesRangee[mot] |= nouvelles[mot];
+            nonVide |= nouvelles[mot];
+        }
+        if (nonVide != 0) {
+            if (*premiere > y) {
+                *premiere = y;
+            }
+            *derniere = y;
+        }
+    }
+}
+
+/**
+ * @brief Calcule la distance de chaque case du plateau à une pomme.
+ *
+ * Les pommes et les pavés ne bougent pas de la partie : un parcours en largeur
+ * lancé depuis la pomme, portails compris, donne une fois pour toutes le
+ * nombre de pas minimal depuis n'importe quelle case. Les déplacements étant
+ * réversibles, ce parcours depuis la pomme équivaut à un parcours vers elle.
+ *
+ * Le champ couvre tout le plateau, rangé selon INDICE_CASE : nombre de pas
+ * depuis chaque case, DISTANCE_INCONNUE pour les cases d'où la pomme est
+ * inaccessible.
+ *
+ * Un pas du parcours par bits coûte une passe sur les rangées de la
+ * frontière, quelle que soit sa taille : il l'emporte tant que le plateau
+ * reste de l'ordre de quelques centaines de cases de côté, au-delà le
+ * parcours case par case reprend l'avantage.
+ *
+ * @param cibleX Position X de la pomme.
+ * @param cibleY Position Y de la pomme.
+ * @param plateau Le plateau de jeu.
+ * @param parcours Mémoire du parcours, conservée par l'appelant d'un champ à l'autre.
+ * @param distances Champ de distances à remplir.
+ */
+void calculerDistances(int cibleX, int cibleY, tPlateau *plateau, tParcours *parcours, short distances[]) {
+    if (largeurPlateau + hauteurPlateau <= DEMI_PERIMETRE_MAX_BITS) {
+        calculerDistancesParBits(cibleX, cibleY, plateau, parcours, distances);
+    } else {
+        calculerDistancesParFile(cibleX, cibleY, plateau, parcours, distances);
+    }
+}
+
+/**
+ * @brief Libère la mémoire des parcours qui calculent les champs de distances.
+ *
+ * @param parcours Mémoire à détruire.
+ */
+void detruireParcours(tParcours *parcours) {
+    free(parcours->libres.lesMots);
+    free(parcours->atteintes.lesMots);
+    free(parcours->frontiere.lesMots);
+    free(parcours->suivante.lesMots);
+    free(parcours->file.lesCases);
+}
+
+/**
+ * @brief Calcule le champ de distances d'une pomme par un parcours en largeur par bits.
+ *
+ * Le parcours avance par rangées entières de bits (voir etendreFrontiere()) :
+ * chaque pas donne d'un coup toutes les cases à la distance suivante, qui
+ * sont ensuite reportées dans le champ.
+ *
+ * @param cibleX Position X de la pomme.
+ * @param cibleY Position Y de la pomme.
+ * @param plateau Le plateau de jeu.
+ * @param parcours Mémoire du parcours, dont les couches sont allouées au premier appel.
+ * @param distances Champ de distances à remplir.
+ */
+void calculerDistancesParBits(int cibleX, int cibleY, tPlateau *plateau, tParcours *parcours, short distances[]) {
+    tBitboard *libres = &parcours->libres, *atteintes = &parcours->atteintes;
+    int premiere = cibleY, derniere = cibleY;
+
+    if (libres->lesMots == NULL) {
+        creerBitboard(libres);
+        creerBitboard(atteintes);
+        creerBitboard(&parcours->frontiere);
+        creerBitboard(&parcours->suivante);
+    }
+    // La frontière et la suivante échangent leurs rôles à chaque pas
+    tBitboard frontiere = parcours->frontiere, suivante = parcours->suivante;
+    remplirCasesLibres(plateau, libres);
+    memset(atteintes->lesMots, 0, (size_t)(hauteurPlateau + 1) * atteintes->nbMots * sizeof(uint64_t));
+
+    for (size_t i = 0; i < NB_INDICES_CASES; i++) {
+        distances[i] = DISTANCE_INCONNUE;
+    }
+    distances[INDICE_CASE(cibleX, cibleY)] = 0;
+    MOT_BITBOARD(&frontiere, cibleY, cibleX / BITS_PAR_MOT) = (uint64_t)1 << (cibleX % BITS_PAR_MOT);
+    MOT_BITBOARD(atteintes, cibleY, cibleX / BITS_PAR_MOT) = (uint64_t)1 << (cibleX % BITS_PAR_MOT);
+
+    for (short distance = 1; premiere <= derniere; distance++) {
+        int anciennePremiere = premiere, ancienneDerniere = derniere;
+        etendreFrontiere(&frontiere, &premiere, &derniere, libres, atteintes, &suivante);
+
+        // Report des cases atteintes à ce pas dans le champ
+        for (int y = premiere; y <= derniere; y++) {
+            for (int mot = 0; mot < suivante.nbMots; mot++) {
+                for (uint64_t bits = MOT_BITBOARD(&suivante, y, mot); bits != 0; bits &= bits - 1) {
+                    distances[INDICE_CASE(mot * BITS_PAR_MOT + __builtin_ctzll(bits), y)] = distance;
+                }
+            }
+        }
+
+        // L'ancienne frontière est remise à 0 et sert de tampon au pas suivant
+        memset(&MOT_BITBOARD(&frontiere, anciennePremiere, 0), 0, (size_t)(ancienneDerniere - anciennePremiere + 1) * frontiere.nbMots * sizeof(uint64_t));
+        tBitboard echange = frontiere;
+        frontiere = suivante;
+        suivante = echange;
+    }
+    parcours->frontiere = frontiere;
+    parcours->suivante = suivante;
+}
+
+/**
+ * @brief Calcule le champ de distances d'une pomme par un parcours en largeur case par case.
+ *
+ * @param cibleX Position X de la pomme.
+ * @param cibleY Position Y de la pomme.
+ * @param plateau Le plateau de jeu.
+ * @param parcours Mémoire du parcours, dont la file grandit à la demande.
+ * @param distances Champ de distances à remplir.
+ */
+void calculerDistancesParFile(int cibleX, int cibleY, tPlateau *plateau, tParcours *parcours, short distances[]) {
+    tFile *file = &parcours->file;
+
+    for (size_t i = 0; i < NB_INDICES_CASES; i++) {
+        distances[i] = DISTANCE_INCONNUE;
+    }
+    distances[INDICE_CASE(cibleX, cibleY)] = 0;
+    enfiler(file, INDICE_CASE(cibleX, cibleY));
+
+    while (file->nbCases > 0) {
+        int indice = defiler(file);
+        int x = CASE_X(indice);
+        int y = CASE_Y(indice);
+
+        for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+            int voisinX, voisinY;
+            caseVoisine(x, y, direction, &voisinX, &voisinY);
+            int voisin = INDICE_CASE(voisinX, voisinY);
+            if (distances[voisin] == DISTANCE_INCONNUE && !caseObstacle(voisinX, voisinY, plateau)) {
+                distances[voisin] = distances[indice] + 1;
+                enfiler(file, voisin);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Crée une mémoire en tuiles dont aucune tuile n'est encore allouée.
+ *
+ * @param memoire Mémoire à créer.
+ * @param tailleCase Nombre d'octets d'une case.
+ * @param octetVide Octet qui remplit les cases d'une tuile effacée.
+ */
+void creerMemoireTuiles(tMemoireTuiles *memoire, size_t tailleCase, unsigned char octetVide) {
+    memoire->nbTuilesX = (largeurPlateau + 1 + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    memoire->nbTuilesY = (hauteurPlateau + 1 + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    memoire->tailleCase = tailleCase;
+    memoire->octetVide = octetVide;
+    memoire->generation = 0;
+    memoire->lesTuiles = calloc((size_t)memoire->nbTuilesX * memoire->nbTuilesY, sizeof(char *));
+    memoire->lesGenerations = calloc((size_t)memoire->nbTuilesX * memoire->nbTuilesY, sizeof(unsigned int));
+    if (memoire->lesTuiles == NULL || memoire->lesGenerations == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Périme toutes les tuiles d'une mémoire sans les parcourir.
+ *
+ * @param memoire La mémoire.
+ */
+void nouvelleGeneration(tMemoireTuiles *memoire) {
+    memoire->generation++;
+    if (memoire->generation == 0) {
+        // Le compteur a fait le tour : toutes les tuiles sont remises à la génération 0, donc périmées
+        memset(memoire->lesGenerations, 0, (size_t)memoire->nbTuilesX * memoire->nbTuilesY * sizeof(unsigned int));
+        memoire->generation = 1;
+    }
+}
+
+/**
+ * @brief Donne l'adresse d'une case pour la génération en cours.
+ *
+ * La tuile de la case est allouée à sa première visite et effacée à la
+ * première visite de chaque nouvelle génération.
+ *
+ * @param memoire La mémoire.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @return L'adresse de la case, valable jusqu'à la destruction de la mémoire.
+ */
+void *caseMemoire(tMemoireTuiles *memoire, int x, int y) {
+    int numeroTuile = (y / TAILLE_TUILE) * memoire->nbTuilesX + x / TAILLE_TUILE;
+    char **tuile = &memoire->lesTuiles[numeroTuile];
+    if (*tuile == NULL) {
+        *tuile = malloc(TAILLE_TUILE * TAILLE_TUILE * memoire->tailleCase);
+        if (*tuile == NULL) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+        memoire->lesGenerations[numeroTuile] = 0;
+    }
+    if (memoire->lesGenerations[numeroTuile] != memoire->generation) {
+        memset(*tuile, memoire->octetVide, TAILLE_TUILE * TAILLE_TUILE * memoire->tailleCase);
+        memoire->lesGenerations[numeroTuile] = memoire->generation;
+    }
+    return *tuile + ((y % TAILLE_TUILE) * TAILLE_TUILE + x % TAILLE_TUILE) * memoire->tailleCase;
+}
+
+/**
+ * @brief Indique si une case a pu recevoir une valeur pendant la génération en cours.
+ *
+ * Contrairement à caseMemoire(), ne touche à aucune tuile.
+ *
+ * @param memoire La mémoire.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @return false si la case vaut sûrement octetVide.
+ */
+bool caseConnue(tMemoireTuiles *memoire, int x, int y) {
+    int numeroTuile = (y / TAILLE_TUILE) * memoire->nbTuilesX + x / TAILLE_TUILE;
+    return memoire->lesTuiles[numeroTuile] != NULL && memoire->lesGenerations[numeroTuile] == memoire->generation;
+}
+
+/**
+ * @brief Libère toute la mémoire en tuiles.
+ *
+ * @param memoire Mémoire à détruire (sans effet si elle n'a jamais été créée).
+ */
+void detruireMemoireTuiles(tMemoireTuiles *memoire) {
+    if (memoire->lesTuiles == NULL) {
+        return;
+    }
+    for (int i = 0; i < memoire->nbTuilesX * memoire->nbTuilesY; i++) {
+        free(memoire->lesTuiles[i]);
+    }
+    free(memoire->lesTuiles);
+    free(memoire->lesGenerations);
+    memoire->lesTuiles = NULL;
+}
+
+/**
+ * @brief Prépare la mémoire de la recherche A* pour une nouvelle recherche.
+ *
+ * Le tas et les nœuds sont vidés sans être libérés, et les tuiles deviennent
+ * périmées sans être parcourues.
+ *
+ * @param recherche Mémoire de la recherche.
+ */
+void preparerRecherche(tRecherche *recherche) {
+    if (recherche->noeuds.lesTuiles == NULL) {
+        creerMemoireTuiles(&recherche->noeuds, sizeof(int), OCTET_AUCUN_NOEUD);
+    }
+    nouvelleGeneration(&recherche->noeuds);
+    recherche->nbNoeuds = 0;
+    recherche->nbOuverts = 0;
+}
+
+/**
+ * @brief Libère la mémoire de la recherche A*.
+ *
+ * @param recherche Mémoire à détruire.
+ */
+void detruireRecherche(tRecherche *recherche) {
+    detruireMemoireTuiles(&recherche->noeuds);
+    free(recherche->lesNoeuds);
+    free(recherche->leTas);
+}
+
+/**
+ * @brief Indique si un nœud doit sortir du tas avant un autre.
+ *
+ * Le nœud le plus prometteur est celui dont le coût total estimé est le plus
+ * faible ; à égalité, le plus avancé passe en premier pour filer vers la cible.
+ *
+ * @param recherche Mémoire de la recherche.
+ * @param noeudA Premier nœud.
+ * @param noeudB Second nœud.
+ * @return true si noeudA passe avant noeudB.
+ */
+bool noeudPrioritaire(tRecherche *recherche, int noeudA, int noeudB) {
+    tNoeud *a = &recherche->lesNoeuds[noeudA];
+    tNoeud *b = &recherche->lesNoeuds[noeudB];
+    int totalA = a->cout + a->estimation;
+    int totalB = b->cout + b->estimation;
+    return totalA < totalB || (totalA == totalB && a->cout > b->cout);
+}
+
+/**
+ * @brief Crée le nœud d'une case, en fait le nœud de la case et l'ajoute au tas.
+ *
+ * Les tableaux des nœuds et du tas doublent quand ils sont pleins et gardent
+ * leur taille pour les recherches suivantes.
+ *
+ * @param recherche Mémoire de la recherche.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param cout Nombre de pas depuis le départ.
+ * @param estimation Estimation du nombre de pas restants.
+ * @param parent Nœud d'où l'on vient, AUCUN_NOEUD pour le départ.
+ * @param direction Direction de la ligne droite qui mène du parent à la case.
+ * @return Le numéro du nœud créé.
+ */
+int ajouterNoeud(tRecherche *recherche, int x, int y, int cout, int estimation, int parent, int direction) {
+    if (recherche->nbNoeuds == recherche->capaciteNoeuds) {
+        recherche->capaciteNoeuds = (recherche->capaciteNoeuds == 0) ? TAILLE_TUILE * TAILLE_TUILE : 2 * recherche->capaciteNoeuds;
+        recherche->lesNoeuds = realloc(recherche->lesNoeuds, (size_t)recherche->capaciteNoeuds * sizeof(tNoeud));
+        if (recherche->lesNoeuds == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (recherche->nbOuverts == recherche->capaciteTas) {
+        recherche->capaciteTas = (recherche->capaciteTas == 0) ? TAILLE_TUILE * TAILLE_TUILE : 2 * recherche->capaciteTas;
+        recherche->leTas = realloc(recherche->leTas, (size_t)recherche->capaciteTas * sizeof(int));
+        if (recherche->leTas == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int noeud = recherche->nbNoeuds++;
+    recherche->lesNoeuds[noeud] = (tNoeud){INDICE_CASE(x, y), cout, estimation, parent, direction, false};
+    *(int *)caseMemoire(&recherche->noeuds, x, y) = noeud;
+
+    // Remonte le nouveau nœud tant qu'il passe avant son parent dans le tas
+    int position = recherche->nbOuverts++;
+    while (position > 0 && noeudPrioritaire(recherche, noeud, recherche->leTas[(position - 1) / 2])) {
+        recherche->leTas[position] = recherche->leTas[(position - 1) / 2];
+        position = (position - 1) / 2;
+    }
+    recherche->leTas[position] = noeud;
+    return noeud;
+}
+
+/**
+ * @brief Retire du tas le nœud le plus prometteur.
+ *
+ * @param recherche Mémoire de la recherche (tas non vide).
+ * @return Le numéro du nœud retiré.
+ */
+int extraireNoeud(tRecherche *recherche) {
+    int premier = recherche->leTas[0];
+    int dernier = recherche->leTas[--recherche->nbOuverts];
+    int position = 0;
+
+    // Descend le dernier nœud depuis la racine jusqu'à ce que ses fils passent après lui
+    while (2 * position + 1 < recherche->nbOuverts) {
+        int fils = 2 * position + 1;
+        if (fils + 1 < recherche->nbOuverts && noeudPrioritaire(recherche, recherche->leTas[fils + 1], recherche->leTas[fils])) {
+            fils++;
+        }
+        if (!noeudPrioritaire(recherche, recherche->leTas[fils], dernier)) {
+            break;
+        }
+        recherche->leTas[position] = recherche->leTas[fils];
+        position = fils;
+    }
+    recherche->leTas[position] = dernier;
+    return premier;
+}
+
+/**
+ * @brief Indique si la tête peut entrer dans une case à un tour donné.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param tour Tour d'arrivée de la tête (1 pour le pas joué maintenant).
+ * @param serpent Indice du serpent.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @return true si la case est libre, ou occupée par un anneau du serpent parti
+ * avant ce tour, et n'est pas réservée par un autre serpent (voir caseReservee()).
+ */
+bool caseFranchissable(int x, int y, int tour, int serpent, tPlateau *plateau, tOccupation *occupation) {
+    return (!bitObstacle(x, y, plateau, occupation) || anneauParti(x, y, serpent, tour, plateau, occupation))
+           && !caseReservee(x, y, serpent, tour, occupation);
+}
+
+/**
+ * @brief Indique si une case libre est un portail.
+ *
+ * Les bords du plateau sont des bordures en dehors des portails : une case
+ * libre du bord en est forcément un.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @return true si la case est sur un bord du plateau.
+ */
+bool casePortail(int x, int y) {
+    return x == 1 || x == largeurPlateau || y == 1 || y == hauteurPlateau;
+}
+
+/**
+ * @brief Indique si une case touche un anneau du serpent lui-même.
+ *
+ * Ces anneaux partent au fil des tours : une case voisine bloquée quand un
+ * saut passe peut être libre pour un chemin plus long. Les règles des sauts ne
+ * valant que pour des obstacles fixes, ces cases sont développées comme dans
+ * la recherche case par case.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param serpent Indice du serpent.
+ * @param occupation Occupation des serpents.
+ * @return true si une des cases voisines porte un anneau du serpent.
+ */
+bool procheDuCorps(int x, int y, int serpent, tOccupation *occupation) {
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        int voisinX, voisinY;
+        caseVoisine(x, y, direction, &voisinX, &voisinY);
+        if (collision(voisinX, voisinY, occupation) && ((tPassage *)caseMemoire(&occupation->passages, voisinX, voisinY))->serpent == serpent) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Indique si une case atteinte par un pas horizontal a un voisin forcé
+ * dans une direction verticale.
+ *
+ * Les chemins canoniques font leurs pas verticaux au plus tôt : descendre ou
+ * monter après un pas horizontal n'est utile que si la même case n'était pas
+ * accessible en faisant le pas vertical d'abord, c'est-à-dire si la case à
+ * côté de la précédente était bloquée quand le chemin y serait passé.
+ *
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param direction Direction horizontale du pas qui mène à la case.
+ * @param vertical Direction verticale examinée.
+ * @param cout Tour où la tête atteint la case.
+ * @param serpent Indice du serpent.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @return true si le chemin doit pouvoir tourner vers vertical depuis cette case.
+ */
+bool voisinForce(int x, int y, int direction, int vertical, int cout, int serpent, tPlateau *plateau, tOccupation *occupation) {
+    int precedentX, precedentY, cotePrecedentX, cotePrecedentY, coteX, coteY;
+    caseVoisine(x, y, DIRECTION_OPPOSEE(direction), &precedentX, &precedentY);
+    caseVoisine(precedentX, precedentY, vertical, &cotePrecedentX, &cotePrecedentY);
+    caseVoisine(x, y, vertical, &coteX, &coteY);
+    return !caseFranchissable(cotePrecedentX, cotePrecedentY, cout, serpent, plateau, occupation)
+           && caseFranchissable(coteX, coteY, cout + 1, serpent, plateau, occupation);
+}
+
+/**
+ * @brief Compte les cases qu'un saut horizontal peut franchir sans les examiner.
+ *
+ * Une case est sans événement si elle est libre, ne touche aucun anneau, n'a
+ * pas de voisin forcé même en comptant tous les anneaux comme fixes, et n'est
+ * ni la cible ni un portail : sauter() la traverserait sans s'arrêter. Les
+ * trois rangées sont lues mot par mot dans les couches, jusqu'au bord de la
+ * tuile de la case de départ.
+ *
+ * @param x Position X de la case de départ du saut.
+ * @param y Position Y de la case de départ du saut.
+ * @param direction Direction horizontale du saut.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @return Le nombre de cases sans événement qui suivent la case de départ.
+ */
+int casesSansEvenement(int x, int y, int direction, int cibleX, int cibleY, tPlateau *plateau, tOccupation *occupation) {
+    int bit = x % TAILLE_TUILE;
+    int origine = x - bit;
+
+    // Sur les rangées des bords, chaque case libre est un portail
+    if (y == 1 || y == hauteurPlateau) {
+        return 0;
+    }
+    uint64_t bloquees = lireMot(&plateau->bordures, x, y) | lireMot(&plateau->paves, x, y) | lireMot(&occupation->corps, x, y);
+    uint64_t dessus = lireMot(&plateau->bordures, x, y - 1) | lireMot(&plateau->paves, x, y - 1) | lireMot(&occupation->corps, x, y - 1);
+    uint64_t dessous = lireMot(&plateau->bordures, x, y + 1) | lireMot(&plateau->paves, x, y + 1) | lireMot(&occupation->corps, x, y + 1);
+    uint64_t anneaux = lireMot(&occupation->corps, x, y);
+    uint64_t evenements = bloquees | anneaux << 1 | anneaux >> 1
+                          | lireMot(&occupation->corps, x, y - 1) | lireMot(&occupation->corps, x, y + 1);
+
+    // Voisin forcé : case du dessus ou du dessous libre alors que celle d'avant est bloquée
+    if (direction == 2) {
+        evenements |= (dessus << 1 & ~dessus) | (dessous << 1 & ~dessous);
+    } else {
+        evenements |= (dessus >> 1 & ~dessus) | (dessous >> 1 & ~dessous);
+    }
+    if (cibleY == y && cibleX >= origine && cibleX < origine + TAILLE_TUILE) {
+        evenements |= 1ULL << (cibleX - origine);
+    }
+    if (origine == 0) {
+        evenements |= 1ULL << 1;
+    }
+    if (largeurPlateau < origine + TAILLE_TUILE) {
+        evenements |= 1ULL << (largeurPlateau - origine);
+    }
+
+    // Les cases des bouts du mot dépendent de la tuile voisine : elles sont examinées par sauter()
+    if (direction == 2) {
+        return (bit >= TAILLE_TUILE - 2) ? 0 : __builtin_ctzll((evenements | 1ULL << (TAILLE_TUILE - 1)) >> (bit + 1));
+    }
+    return (bit <= 1) ? 0 : __builtin_clzll((evenements | 1ULL) << (TAILLE_TUILE - bit));
+}
+
+/**
+ * @brief Avance en ligne droite jusqu'au prochain point de saut.
+ *
+ * Un pas horizontal s'arrête sur une case qui a un voisin forcé (voir
+ * voisinForce()). Un pas vertical s'arrête sur une case d'où un saut
+ * horizontal trouve un point de saut : les cases intermédiaires n'ont pas à
+ * être développées, tout chemin qui y passe ayant un équivalent canonique par
+ * le point de saut. La cible, les portails et les cases qui touchent le corps
+ * du serpent (voir procheDuCorps()), d'où l'on peut repartir dans toutes les
+ * directions, sont toujours des points de saut.
+ *
+ * @param x Position X de départ.
+ * @param y Position Y de départ.
+ * @param direction Direction du saut.
+ * @param cout Tour où la tête atteint la case de départ.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param serpent Indice du serpent.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @param sautX Position X du point de saut trouvé.
+ * @param sautY Position Y du point de saut trouvé.
+ * @return Le nombre de pas jusqu'au point de saut, 0 si la ligne bute sur un obstacle avant.
+ */
+int sauter(int x, int y, int direction, int cout, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation, int *sautX, int *sautY) {
+    int pas = 0;
+    int suivantX, suivantY;
+
+    while (true) {
+        if (!DIRECTION_VERTICALE(direction)) {
+            int nbCases = casesSansEvenement(x, y, direction, cibleX, cibleY, plateau, occupation);
+            x += nbCases * DEPLACEMENT_X[direction];
+            pas += nbCases;
+        }
+        caseVoisine(x, y, direction, sautX, sautY);
+        pas++;
+        if (!caseFranchissable(*sautX, *sautY, cout + pas, serpent, plateau, occupation)) {
+            return 0;
+        }
+        if ((*sautX == cibleX && *sautY == cibleY) || casePortail(*sautX, *sautY) || procheDuCorps(*sautX, *sautY, serpent, occupation)) {
+            return pas;
+        }
+        if (DIRECTION_VERTICALE(direction)) {
+            for (int horizontal = 2; horizontal < NB_DIRECTIONS; horizontal++) {
+                if (sauter(*sautX, *sautY, horizontal, cout + pas, cibleX, cibleY, serpent, plateau, occupation, &suivantX, &suivantY) > 0) {
+                    return pas;
+                }
+            }
+        } else {
+            for (int vertical = 0; vertical < 2; vertical++) {
+                if (voisinForce(*sautX, *sautY, direction, vertical, cout + pas, serpent, plateau, occupation)) {
+                    return pas;
+                }
+            }
+        }
+        x = *sautX;
+        y = *sautY;
+    }
+}
+
+/**
+ * @brief Cherche le plus court chemin vers une cible par sauts (Jump Point Search).
+ *
+ * Variante à quatre directions de la recherche A* : au lieu des cases
+ * voisines, chaque nœud développe les points de saut que trouve sauter() dans
+ * les directions utiles selon le pas qui y mène. Sur un plateau dégagé, les
+ * lignes droites entre deux points de saut sont parcourues sans créer de
+ * nœud, et seul un des chemins symétriques de même longueur est exploré.
+ *
+ * @param recherche Mémoire de la recherche, préparée par preparerRecherche().
+ * @param departX Position X de la tête du serpent.
+ * @param departY Position Y de la tête du serpent.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param serpent Indice du serpent qui cherche le chemin.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @return Le nœud de la cible, AUCUN_NOEUD si elle est inaccessible.
+ */
+int chercherParSauts(tRecherche *recherche, int departX, int departY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation) {
+    int portailX, portailY;
+    bool utilisePortail;
+
+    ajouterNoeud(recherche, departX, departY, 0,
+                 calculerDistanceOptimale(departX, departY, cibleX, cibleY, &portailX, &portailY, &utilisePortail), AUCUN_NOEUD, AUCUNE_DIRECTION);
+
+    while (recherche->nbOuverts > 0) {
+        int noeud = extraireNoeud(recherche);
+        // Les champs sont recopiés : ajouterNoeud() peut déplacer le tableau des nœuds
+        int x = CASE_X(recherche->lesNoeuds[noeud].indice);
+        int y = CASE_Y(recherche->lesNoeuds[noeud].indice);
+        int cout = recherche->lesNoeuds[noeud].cout;
+        int arrivee = recherche->lesNoeuds[noeud].direction;
+
+        // Un nœud remplacé par un chemin plus court vers sa case est ignoré
+        if (recherche->lesNoeuds[noeud].ferme || *(int *)caseMemoire(&recherche->noeuds, x, y) != noeud) {
+            continue;
+        }
+        recherche->lesNoeuds[noeud].ferme = true;
+        if (x == cibleX && y == cibleY) {
+            return noeud;
+        }
+
+        // Directions utiles : toutes au départ, aux portails et contre le corps, sinon tout droit, plus les côtés après un pas vertical et les voisins forcés après un pas horizontal
+        int directions = TOUTES_DIRECTIONS;
+        if (arrivee != AUCUNE_DIRECTION && !casePortail(x, y) && !procheDuCorps(x, y, serpent, occupation)) {
+            directions = 1 << arrivee;
+            if (DIRECTION_VERTICALE(arrivee)) {
+                directions |= 1 << 2 | 1 << 3;
+            } else {
+                for (int vertical = 0; vertical < 2; vertical++) {
+                    if (voisinForce(x, y, arrivee, vertical, cout, serpent, plateau, occupation)) {
+                        directions |= 1 << vertical;
+                    }
+                }
+            }
+        }
+
+        for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+            int sautX, sautY;
+            if (!((directions >> direction) & 1)) {
+                continue;
+            }
+            int pas = sauter(x, y, direction, cout, cibleX, cibleY, serpent, plateau, occupation, &sautX, &sautY);
+            if (pas == 0) {
+                continue;
+            }
+            int voisin = *(int *)caseMemoire(&recherche->noeuds, sautX, sautY);
+            if (voisin != AUCUN_NOEUD && recherche->lesNoeuds[voisin].cout <= cout + pas) {
+                continue;
+            }
+            int estimation = calculerDistanceOptimale(sautX, sautY, cibleX, cibleY, &portailX, &portailY, &utilisePortail);
+            ajouterNoeud(recherche, sautX, sautY, cout + pas, estimation, noeud, direction);
+        }
+    }
+    return AUCUN_NOEUD;
+}
+
+/**
+ * @brief Cherche le plus court chemin vers une cible case par case (A*).
+ *
+ * Si la cible est inaccessible, donne la case atteinte la plus proche de la
+ * cible selon calculerDistanceOptimale() (la plus proche de la tête à
+ * égalité).
+ *
+ * @param recherche Mémoire de la recherche, préparée par preparerRecherche().
+ * @param departX Position X de la tête du serpent.
+ * @param departY Position Y de la tête du serpent.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param serpent Indice du serpent qui cherche le chemin.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @param trouve Reçoit true si la cible a été atteinte.
+ * @return Le nœud de la cible ou de la case la plus proche, AUCUN_NOEUD si aucune case voisine n'est libre.
+ */
+int chercherCaseParCase(tRecherche *recherche, int departX, int departY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation, bool *trouve) {
+    int arrivee = AUCUN_NOEUD;
+    int plusProche = -1, estimationMin = -1, coutMin = -1;
+    int portailX, portailY;
+    bool utilisePortail;
+
+    *trouve = false;
+    ajouterNoeud(recherche, departX, departY, 0,
+                 calculerDistanceOptimale(departX, departY, cibleX, cibleY, &portailX, &portailY, &utilisePortail), AUCUN_NOEUD, AUCUNE_DIRECTION);
+
+    while (recherche->nbOuverts > 0 && !*trouve) {
+        int noeud = extraireNoeud(recherche);
+        // Les champs sont recopiés : ajouterNoeud() peut déplacer le tableau des nœuds
+        int x = CASE_X(recherche->lesNoeuds[noeud].indice);
+        int y = CASE_Y(recherche->lesNoeuds[noeud].indice);
+        int cout = recherche->lesNoeuds[noeud].cout;
+
+        // Un nœud remplacé par un chemin plus court vers sa case est ignoré
+        if (recherche->lesNoeuds[noeud].ferme || *(int *)caseMemoire(&recherche->noeuds, x, y) != noeud) {
+            continue;
+        }
+        recherche->lesNoeuds[noeud].ferme = true;
+        if (x == cibleX && y == cibleY) {
+            *trouve = true;
+            arrivee = noeud;
+            continue;
+        }
+
+        int libres = voisinsLibres(x, y, plateau, occupation);
+        for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+            int voisinX, voisinY;
+            caseVoisine(x, y, direction, &voisinX, &voisinY);
+            // La tête atteindrait la case au tour cout + 1
+            if ((!((libres >> direction) & 1) && !anneauParti(voisinX, voisinY, serpent, cout + 1, plateau, occupation))
+                || caseReservee(voisinX, voisinY, serpent, cout + 1, occupation)) {
+                continue;
+            }
+            int voisin = *(int *)caseMemoire(&recherche->noeuds, voisinX, voisinY);
+            if (voisin != AUCUN_NOEUD && recherche->lesNoeuds[voisin].cout <= cout + 1) {
+                continue;
+            }
+            int estimation = calculerDistanceOptimale(voisinX, voisinY, cibleX, cibleY, &portailX, &portailY, &utilisePortail);
+            ajouterNoeud(recherche, voisinX, voisinY, cout + 1, estimation, noeud, direction);
+
+            // Au cas où la cible serait inaccessible : retient la case atteinte la plus proche de la cible
+            if (plusProche == -1 || estimation < estimationMin || (estimation == estimationMin && cout + 1 < coutMin)) {
+                plusProche = INDICE_CASE(voisinX, voisinY);
+                estimationMin = estimation;
+                coutMin = cout + 1;
+            }
+        }
+    }
+    if (!*trouve && plusProche != -1) {
+        arrivee = *(int *)caseMemoire(&recherche->noeuds, CASE_X(plusProche), CASE_Y(plusProche));
+    }
+    return arrivee;
+}
+
+/**
+ * @brief Calcule le plus court chemin vers une cible.
+ *
+ * La recherche traite les portails et le passage d'un bord à l'autre comme
+ * des arêtes ordinaires du graphe. Le coût d'une case étant le tour où la tête
+ * l'atteint, un anneau du serpent lui-même ne bloque sa case que s'il y est
+ * encore à ce tour (voir anneauParti()) : le chemin peut suivre sa propre queue
+ * ou traverser son corps là où il sera parti, au lieu d'en faire le tour.
+ * Chaque case n'est atteinte qu'une fois, au plus tôt ; une case encore occupée
+ * à ce tour-là peut l'être plus tard par un chemin plus long.
+ *
+ * Les corps des autres serpents restent bloquants : leurs queues partent aussi
+ * à l'heure, mais leurs têtes, qui visent la même pomme, reprennent les cases
+ * libérées, et le serpent qui s'y engouffre finit collé à leur sillage.
+ *
+ * Les deux recherches sont guidées par calculerDistanceOptimale(), distance
+ * de Manhattan qui tient compte des portails : elle ne surestime jamais le
+ * nombre de pas restants, si bien que le chemin trouvé est le plus court. La
+ * recherche par sauts (chercherParSauts()) est menée d'abord ; si la cible est
+ * enfermée par les corps, la recherche case par case (chercherCaseParCase())
+ * reprend pour mener le chemin à la case accessible la plus proche de la
+ * cible, pour que le serpent attende au plus près au lieu de s'éloigner. Tant
+ * que la cible reste enfermée, seule cette seconde recherche est menée. Le
+ * chemin complet est conservé pour être rejoué aux tours suivants.
+ *
+ * Avec l'option --reservations, les cases réservées par les autres serpents
+ * bloquent aussi le chemin aux tours où ils y passent (voir caseReservee()).
+ * Les sauts par-dessus les rangées sans obstacle ne voient pas les
+ * réservations : seule la recherche case par case est alors menée.
+ *
+ * La mémoire de la recherche (voir tRecherche) est celle de l'occupation,
+ * conservée d'un appel à l'autre.
+ *
+ * @param departX Position X de la tête du serpent.
+ * @param departY Position Y de la tête du serpent.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param serpent Indice du serpent qui cherche le chemin.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @param chemin Pointeur vers le chemin calculé (vide si aucune case n'est accessible).
+ * @return true si un chemin jusqu'à la cible a été trouvé.
+ */
+bool calculerChemin(int departX, int departY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation, tChemin *chemin) {
+    tRecherche *recherche = &occupation->recherche;
+    bool trouve = true;
+    int arrivee = AUCUN_NOEUD;
+    // Une cible déjà enfermée au tour précédent l'est sans doute encore : la recherche par sauts échouerait après avoir tout parcouru
+    bool enfermee = chemin->cibleX == cibleX && chemin->cibleY == cibleY && !chemin->atteintCible;
+
+    chemin->longueur = 0;
+    chemin->etape = 0;
+    chemin->departX = departX;
+    chemin->departY = departY;
+    chemin->cibleX = cibleX;
+    chemin->cibleY = cibleY;
+
+    if (!enfermee && !modeReservations) {
+        preparerRecherche(recherche);
+        arrivee = chercherParSauts(recherche, departX, departY, cibleX, cibleY, serpent, plateau, occupation);
+    }
+    if (arrivee == AUCUN_NOEUD) {
+        preparerRecherche(recherche);
+        arrivee = chercherCaseParCase(recherche, departX, departY, cibleX, cibleY, serpent, plateau, occupation, &trouve);
+    }
+    chemin->atteintCible = trouve;
+
+    if (arrivee != AUCUN_NOEUD) {
+        // Le coût du nœud d'arrivée est la longueur du chemin
+        chemin->longueur = recherche->lesNoeuds[arrivee].cout;
+        if (chemin->longueur > chemin->capacite) {
+            chemin->capacite = chemin->longueur;
+            chemin->lesX = realloc(chemin->lesX, chemin->capacite * sizeof(int));
+            chemin->lesY = realloc(chemin->lesY, chemin->capacite * sizeof(int));
+            if (chemin->lesX == NULL || chemin->lesY == NULL) {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+        // Chaque nœud est relié à son parent par une ligne droite : les pas sont rejoués depuis le parent
+        for (int noeud = arrivee; recherche->lesNoeuds[noeud].parent != AUCUN_NOEUD; noeud = recherche->lesNoeuds[noeud].parent) {
+            tNoeud *parent = &recherche->lesNoeuds[recherche->lesNoeuds[noeud].parent];
+            int x = CASE_X(parent->indice), y = CASE_Y(parent->indice);
+            for (int pas = parent->cout; pas < recherche->lesNoeuds[noeud].cout; pas++) {
+                caseVoisine(x, y, recherche->lesNoeuds[noeud].direction, &x, &y);
+                chemin->lesX[pas] = x;
+                chemin->lesY[pas] = y;
+            }
+        }
+    }
+    return trouve;
+}
+
+/**
+ * @brief Indique si le chemin calculé à un tour précédent peut encore être suivi.
+ *
+ * Le chemin reste valable tant que la cible n'a pas changé, qu'il y mène
+ * effectivement, que la tête se trouve bien sur le chemin et que le prochain
+ * pas n'a été ni bloqué ni réservé par un autre serpent entre-temps.
+ *
+ * @param chemin Le chemin à vérifier.
+ * @param teteX Position X de la tête du serpent.
+ * @param teteY Position Y de la tête du serpent.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param serpent Indice du serpent qui suit le chemin.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @return true si le prochain pas du chemin peut être joué.
+ */
+bool cheminUtilisable(tChemin *chemin, int teteX, int teteY, int cibleX, int cibleY, int serpent, tPlateau *plateau, tOccupation *occupation) {
+    bool utilisable = false;
+    if (chemin->atteintCible && chemin->etape < chemin->longueur && chemin->cibleX == cibleX && chemin->cibleY == cibleY) {
+        int precedentX = (chemin->etape == 0) ? chemin->departX : chemin->lesX[chemin->etape - 1];
+        int precedentY = (chemin->etape == 0) ? chemin->departY : chemin->lesY[chemin->etape - 1];
+        utilisable = precedentX == teteX && precedentY == teteY
+                     && caseLibre(chemin->lesX[chemin->etape], chemin->lesY[chemin->etape], plateau, occupation)
+                     && !caseReservee(chemin->lesX[chemin->etape], chemin->lesY[chemin->etape], serpent, 1, occupation);
+    }
+    return utilisable;
+}
+
+/**
+ * @brief Indique si le planificateur peut faire passer le chemin par une case.
+ *
+ * La tête du serpent est la seule case occupée qui compte comme praticable :
+ * c'est de là que part le chemin.
+ *
+ * @param planificateur Le planificateur.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @return true si la case est libre ou est la tête du serpent.
+ */
+bool casePraticable(tPlanificateur *planificateur, int x, int y, tPlateau *plateau, tOccupation *occupation) {
+    return !bitObstacle(x, y, plateau, occupation) || (x == planificateur->departX && y == planificateur->departY);
+}
+
+/**
+ * @brief Indique si une entrée doit sortir du tas du planificateur avant une autre.
+ *
+ * @param a Première entrée.
+ * @param b Seconde entrée.
+ * @return true si a passe avant b.
+ */
+bool entreePrioritaire(tEntree a, tEntree b) {
+    return a.cle < b.cle || (a.cle == b.cle && a.cleSecond < b.cleSecond);
+}
+
+/**
+ * @brief Ajoute une case au tas du planificateur avec sa clé actuelle.
+ *
+ * La clé est la plus petite des deux distances de la case, augmentée de
+ * l'estimation du trajet depuis la tête et de la correction due aux
+ * déplacements de la tête. Une entrée plus ancienne de la même case peut
+ * rester dans le tas : elle sera écartée à sa sortie.
+ *
+ * @param planificateur Le planificateur.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ */
+void empilerCase(tPlanificateur *planificateur, int x, int y) {
+    tCouts *couts = caseMemoire(&planificateur->couts, x, y);
+    int portailX, portailY;
+    bool utilisePortail;
+    int distance = (couts->distance < couts->prevision) ? couts->distance : couts->prevision;
+    tEntree entree = {distance + planificateur->correction
+                      + calculerDistanceOptimale(planificateur->departX, planificateur->departY, x, y, &portailX, &portailY, &utilisePortail),
+                      distance, INDICE_CASE(x, y)};
+
+    if (planificateur->nbEntrees == planificateur->capaciteTas) {
+        planificateur->capaciteTas = (planificateur->capaciteTas == 0) ? TAILLE_TUILE * TAILLE_TUILE : 2 * planificateur->capaciteTas;
+        planificateur->leTas = realloc(planificateur->leTas, (size_t)planificateur->capaciteTas * sizeof(tEntree));
+        if (planificateur->leTas == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int position = planificateur->nbEntrees++;
+    while (position > 0 && entreePrioritaire(entree, planificateur->leTas[(position - 1) / 2])) {
+        planificateur->leTas[position] = planificateur->leTas[(position - 1) / 2];
+        position = (position - 1) / 2;
+    }
+    planificateur->leTas[position] = entree;
+}
+
+/**
+ * @brief Retire l'entrée de plus petite clé du tas du planificateur.
+ *
+ * @param planificateur Le planificateur (tas non vide).
+ * @return L'entrée retirée.
+ */
+tEntree depilerCase(tPlanificateur *planificateur) {
+    tEntree premiere = planificateur->leTas[0];
+    tEntree derniere = planificateur->leTas[--planificateur->nbEntrees];
+    int position = 0;
+
+    while (2 * position + 1 < planificateur->nbEntrees) {
+        int fils = 2 * position + 1;
+        if (fils + 1 < planificateur->nbEntrees && entreePrioritaire(planificateur->leTas[fils + 1], planificateur->leTas[fils])) {
+            fils++;
+        }
+        if (!entreePrioritaire(planificateur->leTas[fils], derniere)) {
+            break;
+        }
+        planificateur->leTas[position] = planificateur->leTas[fils];
+        position = fils;
+    }
+    planificateur->leTas[position] = derniere;
+    return premiere;
+}
+
+/**
+ * @brief Recalcule la distance prévue d'une case à partir de ses voisines.
+ *
+ * Une case que cela rend incohérente (prévision différente de la distance
+ * établie) est mise dans le tas pour être revue.
+ *
+ * @param planificateur Le planificateur.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ */
+void reviserCase(tPlanificateur *planificateur, int x, int y, tPlateau *plateau, tOccupation *occupation) {
+    tCouts *couts = caseMemoire(&planificateur->couts, x, y);
+
+    if (x != planificateur->cibleX || y != planificateur->cibleY) {
+        couts->prevision = INFINI;
+        if (casePraticable(planificateur, x, y, plateau, occupation)) {
+            for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+                int voisinX, voisinY;
+                caseVoisine(x, y, direction, &voisinX, &voisinY);
+                tCouts *voisin = caseMemoire(&planificateur->couts, voisinX, voisinY);
+                if (voisin->distance < INFINI && voisin->distance + 1 < couts->prevision
+                    && casePraticable(planificateur, voisinX, voisinY, plateau, occupation)) {
+                    couts->prevision = voisin->distance + 1;
+                }
+            }
+        }
+    }
+    if (couts->distance != couts->prevision) {
+        empilerCase(planificateur, x, y);
+    }
+}
+
+/**
+ * @brief Prend en compte une case qui vient d'être prise ou libérée.
+ *
+ * Les arêtes de la case changent : la case et ses quatre voisines sont revues.
+ * Un changement loin de toute case déjà visitée par la recherche ne peut rien
+ * modifier : il est ignoré sans toucher à la mémoire du planificateur.
+ *
+ * @param planificateur Le planificateur.
+ * @param x Position X de la case.
+ * @param y Position Y de la case.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ */
+void signalerChangement(tPlanificateur *planificateur, int x, int y, tPlateau *plateau, tOccupation *occupation) {
+    int lesVoisinsX[NB_DIRECTIONS], lesVoisinsY[NB_DIRECTIONS];
+    bool connue = caseConnue(&planificateur->couts, x, y);
+
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        caseVoisine(x, y, direction, &lesVoisinsX[direction], &lesVoisinsY[direction]);
+        connue = connue || caseConnue(&planificateur->couts, lesVoisinsX[direction], lesVoisinsY[direction]);
+    }
+    if (!connue) {
+        return;
+    }
+    reviserCase(planificateur, x, y, plateau, occupation);
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        reviserCase(planificateur, lesVoisinsX[direction], lesVoisinsY[direction], plateau, occupation);
+    }
+}
+
+/**
+ * @brief Repart d'un planificateur vide pour une nouvelle pomme.
+ *
+ * Les tableaux du planificateur sont conservés : seules leurs valeurs sont
+ * périmées.
+ *
+ * @param planificateur Le planificateur.
+ * @param departX Position X de la tête du serpent.
+ * @param departY Position Y de la tête du serpent.
+ * @param cibleX Position X de la pomme.
+ * @param cibleY Position Y de la pomme.
+ * @param occupation Grille d'occupation des serpents.
+ */
+void initialiserPlanificateur(tPlanificateur *planificateur, int departX, int departY, int cibleX, int cibleY, tOccupation *occupation) {
+    if (planificateur->couts.lesTuiles == NULL) {
+        creerMemoireTuiles(&planificateur->couts, sizeof(tCouts), OCTET_INFINI);
+    }
+    nouvelleGeneration(&planificateur->couts);
+    planificateur->actif = true;
+    planificateur->cibleX = cibleX;
+    planificateur->cibleY = cibleY;
+    planificateur->departX = departX;
+    planificateur->departY = departY;
+    planificateur->correction = 0;
+    planificateur->changementsLus = occupation->journal.premier + occupation->journal.nbCases;
+    planificateur->nbEntrees = 0;
+
+    tCouts *cible = caseMemoire(&planificateur->couts, cibleX, cibleY);
+    cible->prevision = 0;
+    empilerCase(planificateur, cibleX, cibleY);
+}
+
+/**
+ * @brief Met le planificateur à jour pour la nouvelle position de la tête.
+ *
+ * Les changements d'occupation survenus depuis le dernier appel sont relus
+ * dans le journal. L'ancienne tête, devenue un anneau du corps, est revue elle
+ * aussi. Les clés déjà dans le tas restent valables grâce à la correction,
+ * qui augmente de la distance parcourue par la tête.
+ *
+ * @param planificateur Le planificateur.
+ * @param departX Position X de la tête du serpent.
+ * @param departY Position Y de la tête du serpent.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ */
+void deplacerDepart(tPlanificateur *planificateur, int departX, int departY, tPlateau *plateau, tOccupation *occupation) {
+    tJournal *journal = &occupation->journal;
+    int ancienX = planificateur->departX, ancienY = planificateur->departY;
+    bool deplace = (departX != ancienX || departY != ancienY);
+
+    if (deplace) {
+        int portailX, portailY;
+        bool utilisePortail;
+        planificateur->correction += calculerDistanceOptimale(ancienX, ancienY, departX, departY, &portailX, &portailY, &utilisePortail);
+        planificateur->departX = departX;
+        planificateur->departY = departY;
+    }
+    for (long numero = planificateur->changementsLus; numero < journal->premier + journal->nbCases; numero++) {
+        int indice = journal->lesCases[numero - journal->premier];
+        signalerChangement(planificateur, CASE_X(indice), CASE_Y(indice), plateau, occupation);
+    }
+    planificateur->changementsLus = journal->premier + journal->nbCases;
+    if (deplace) {
+        signalerChangement(planificateur, ancienX, ancienY, plateau, occupation);
+    }
+}
+
+/**
+ * @brief Revoit les cases incohérentes jusqu'à connaître la distance de la tête.
+ *
+ * Seules les cases dont la clé précède celle de la tête sont revues : après un
+ * changement, la recherche ne reprend que dans la zone qu'il affecte et qui
+ * peut raccourcir ou rallonger le chemin de la tête.
+ *
+ * @param planificateur Le planificateur.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ */
+void calculerPlan(tPlanificateur *planificateur, tPlateau *plateau, tOccupation *occupation) {
+    tCouts *depart = caseMemoire(&planificateur->couts, planificateur->departX, planificateur->departY);
+
+    while (planificateur->nbEntrees > 0) {
+        tEntree sommet = planificateur->leTas[0];
+        int x = CASE_X(sommet.indice), y = CASE_Y(sommet.indice);
+        tCouts *couts = caseMemoire(&planificateur->couts, x, y);
+
+        // Une case redevenue cohérente depuis son entrée dans le tas n'est plus à revoir
+        if (couts->distance == couts->prevision) {
+            depilerCase(planificateur);
+            continue;
+        }
+
+        int distanceDepart = (depart->distance < depart->prevision) ? depart->distance : depart->prevision;
+        tEntree cleDepart = {distanceDepart + planificateur->correction, distanceDepart, 0};
+        if (!entreePrioritaire(sommet, cleDepart) && depart->prevision <= depart->distance) {
+            break;
+        }
+        depilerCase(planificateur);
+
+        // Une clé calculée avant un déplacement de la tête peut avoir vieilli : la case repart avec sa clé actuelle
+        int portailX, portailY;
+        bool utilisePortail;
+        int distance = (couts->distance < couts->prevision) ? couts->distance : couts->prevision;
+        tEntree cle = {distance + planificateur->correction
+                       + calculerDistanceOptimale(planificateur->departX, planificateur->departY, x, y, &portailX, &portailY, &utilisePortail),
+                       distance, sommet.indice};
+        if (entreePrioritaire(sommet, cle)) {
+            empilerCase(planificateur, x, y);
+        } else if (couts->distance > couts->prevision) {
+            couts->distance = couts->prevision;
+            for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+                int voisinX, voisinY;
+                caseVoisine(x, y, direction, &voisinX, &voisinY);
+                reviserCase(planificateur, voisinX, voisinY, plateau, occupation);
+            }
+        } else {
+            couts->distance = INFINI;
+            reviserCase(planificateur, x, y, plateau, occupation);
+            for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+                int voisinX, voisinY;
+                caseVoisine(x, y, direction, &voisinX, &voisinY);
+                reviserCase(planificateur, voisinX, voisinY, plateau, occupation);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Donne la case voisine libre de la tête la plus proche de la pomme.
+ *
+ * @param planificateur Le planificateur, à jour (voir calculerPlan()).
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @param prochainX Pointeur vers la position X de la case choisie.
+ * @param prochainY Pointeur vers la position Y de la case choisie.
+ * @return false si aucune case voisine ne mène à la pomme.
+ */
+bool pasSuivant(tPlanificateur *planificateur, tPlateau *plateau, tOccupation *occupation, int *prochainX, int *prochainY) {
+    int distanceMin = INFINI;
+    int libres = voisinsLibres(planificateur->departX, planificateur->departY, plateau, occupation);
+
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        if (!((libres >> direction) & 1)) {
+            continue;
+        }
+        int voisinX, voisinY;
+        caseVoisine(planificateur->departX, planificateur->departY, direction, &voisinX, &voisinY);
+        tCouts *voisin = caseMemoire(&planificateur->couts, voisinX, voisinY);
+        if (voisin->distance < distanceMin) {
+            distanceMin = voisin->distance;
+            *prochainX = voisinX;
+            *prochainY = voisinY;
+        }
+    }
+    return distanceMin < INFINI;
+}
+
+/**
+ * @brief Libère la mémoire d'un planificateur.
+ *
+ * @param planificateur Planificateur à détruire.
+ */
+void detruirePlanificateur(tPlanificateur *planificateur) {
+    detruireMemoireTuiles(&planificateur->couts);
+    free(planificateur->leTas);
+}
+
+/**
+ * @brief Choisit le pas d'un serpent avec son planificateur incrémental.
+ *
+ * Le planificateur prend la main quand aucune case voisine ne rapproche le
+ * serpent de la pomme, et la garde jusqu'à ce que la pomme change : d'un tour
+ * à l'autre, il ne répare que ce que les déplacements des corps ont changé, et
+ * guide le serpent au plus court autour des corps qui bougent. Si la pomme est
+ * enfermée, le serpent s'en rapproche au mieux avec calculerChemin().
+ *
+ * La recherche initiale, menée depuis la pomme, développe toutes les cases à
+ * égalité de distance estimée : elle coûte plus cher qu'une recherche
+ * calculerChemin() sur un plateau dégagé, ce que les réparations ne
+ * rattrapent que si le détour dure.
+ *
+ * @param serpent Le serpent à déplacer.
+ * @param teteX Position X de la tête.
+ * @param teteY Position Y de la tête.
+ * @param cibleX Position X de la pomme.
+ * @param cibleY Position Y de la pomme.
+ * @param rapproche Vrai si une case voisine libre rapproche le serpent de la pomme.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Grille d'occupation des serpents.
+ * @param prochainX Position X du pas choisi, inchangée si le planificateur ne prend pas la main.
+ * @param prochainY Position Y du pas choisi, inchangée si le planificateur ne prend pas la main.
+ */
+void planifierDetour(tSerpent *serpent, int teteX, int teteY, int cibleX, int cibleY, bool rapproche, tPlateau *plateau, tOccupation *occupation, int *prochainX, int *prochainY) {
+    tPlanificateur *planificateur = &serpent->planificateur;
+    tChemin *chemin = &serpent->chemin;
+    bool detourEnCours = planificateur->actif && planificateur->cibleX == cibleX && planificateur->cibleY == cibleY;
+
+    if (!detourEnCours && rapproche) {
+        planificateur->actif = false;
+        return;
+    }
+    if (detourEnCours) {
+        deplacerDepart(planificateur, teteX, teteY, plateau, occupation);
+    } else {
+        initialiserPlanificateur(planificateur, teteX, teteY, cibleX, cibleY, occupation);
+    }
+    calculerPlan(planificateur, plateau, occupation);
+
+    *prochainX = teteX;
+    *prochainY = teteY;
+    if (!pasSuivant(planificateur, plateau, occupation, prochainX, prochainY)) {
+        // Un chemin vide signifie que toutes les cases autour de la tête sont bloquées : le serpent reste sur place
+        calculerChemin(teteX, teteY, cibleX, cibleY, (int)(serpent - occupation->lesSerpents), plateau, occupation, chemin);
+        if (chemin->longueur > 0) {
+            *prochainX = chemin->lesX[0];
+            *prochainY = chemin->lesY[0];
+        }
+    }
+}
+
+/**
+ * @brief Départage deux cases voisines de la tête aussi proches de la pomme visée.
+ *
+ * L'ordre des pommes étant fixé et chacune étant mangée sur sa case, la
+ * longueur du trajet à travers les prochaines pommes ne dépend pas des plus
+ * courts chemins choisis : seul compte l'endroit où ils laissent le serpent.
+ * Les cases sont comparées sur la pomme qui suit la pomme visée, puis sur
+ * celle d'après :
+ *  - un serpent qui ne mangera pas la pomme visée attend la suivante d'autant
+ *    plus près qu'il est passé près d'elle, la case la plus proche l'emporte ;
+ *  - dans les derniers pas avant la pomme, qui formeront le corps quand elle
+ *    sera mangée, la case la plus éloignée de la pomme suivante l'emporte, pour
+ *    que le corps reste derrière la tête au lieu de barrer le trajet suivant.
+ *
+ * @param itineraire Champs de distances de la pomme visée et des suivantes.
+ * @param rang Rang dans l'itinéraire de la pomme visée.
+ * @param caseA Indice (INDICE_CASE) de la première case.
+ * @param caseB Indice de la seconde case.
+ * @param distance Distance commune des deux cases à la pomme visée.
+ * @param longueur Longueur du serpent quand il aura mangé la pomme.
+ * @return true si caseA laisse le serpent mieux placé que caseB.
+ */
+bool mieuxPlacee(tItineraire *itineraire, int rang, int caseA, int caseB, int distance, int longueur) {
+    for (int i = rang + 1; i < itineraire->nbChamps; i++) {
+        int distanceA = itineraire->lesChamps[i][caseA];
+        int distanceB = itineraire->lesChamps[i][caseB];
+        if (distanceA != distanceB && distanceA != DISTANCE_INCONNUE && distanceB != DISTANCE_INCONNUE) {
+            return (i == rang + 1 && distance <= longueur) ? distanceA > distanceB : distanceA < distanceB;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Déplace le serpent d'une case vers la cible.
+ *
+ * Le serpent descend le champ de distances de la pomme qu'il vise (rangPomme
+ * dans l'itinéraire) : il avance sur la case
+ * voisine libre la plus proche de la pomme, sans aucune recherche, en
+ * départageant les cases aussi proches selon les pommes suivantes (voir
+ * mieuxPlacee()). Ce n'est
+ * que lorsque toutes les cases qui le rapprochent sont occupées par un corps,
+ * ou réservées par un autre serpent avec l'option --reservations (voir
+ * reserverPlan()), qu'il calcule un détour avec calculerChemin(). Un coup
+ * imposé par l'agent MCTS ou alpha-bêta (directionImposee) remplace tout ce
+ * choix. Le détour est réutilisé d'un
+ * tour à l'autre jusqu'à ce qu'il soit terminé ou bloqué. Avec l'option
+ * --detours-incrementaux, le détour est confié à planifierDetour().
+ *
+ * Un serpent qui a encore des anneaux à gagner garde sa queue en place : il
+ * s'allonge d'un anneau. Seuls la queue, l'ancienne tête et la nouvelle tête
+ * sont redessinées, quelle que soit la longueur du serpent.
+ *
+ * @param serpent Le serpent à déplacer.
+ * @param occupation Grille d'occupation de tous les serpents.
+ * @param itineraire Champs de distances de la pomme visée et des suivantes.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param plateau Le plateau de jeu.
+ * @param pomme Pointeur vers une variable booléenne indiquant si la pomme présente est mangée.
+ */
+void progresser(tSerpent *serpent, tOccupation *occupation, tItineraire *itineraire, int cibleX, int cibleY, tPlateau *plateau, bool *pomme) {
+    tChemin *chemin = &serpent->chemin;
+    int indiceSerpent = (int)(serpent - occupation->lesSerpents);
+    int teteX = ANNEAU(serpent, 0).x, teteY = ANNEAU(serpent, 0).y;
+    int prochainX = teteX, prochainY = teteY;
+
+    if (serpent->aGrandir > 0) {
+        // La queue reste en place : le serpent compte un anneau de plus
+        serpent->aGrandir--;
+        if (serpent->taille == serpent->capacite) {
+            agrandirAnneaux(serpent);
+        }
+        serpent->taille++;
+    } else {
+        // Libère la case de la queue, et l'efface si aucun autre anneau ne s'y trouve
+        tAnneau queue = ANNEAU(serpent, serpent->taille - 1);
+        deplacerAnneau(queue.x, queue.y, -1, occupation);
+        if (!collision(queue.x, queue.y, occupation)) {
+            effacer(queue.x, queue.y);
+        }
+    }
+
+    // La nouvelle tête prend l'indice qui précède l'ancienne : le corps ne bouge pas
+    serpent->indiceTete = (serpent->indiceTete + serpent->capacite - 1) & (serpent->capacite - 1);
+    serpent->numeroTete++;
+
+    bool rapproche = choisirVoisin(serpent, teteX, teteY, 1, itineraire, plateau, occupation, &prochainX, &prochainY);
+    int directionImposee = serpent->directionImposee;
+    serpent->directionImposee = AUCUNE_DIRECTION;
+
+    if (directionImposee != AUCUNE_DIRECTION && ((voisinsLibres(teteX, teteY, plateau, occupation) >> directionImposee) & 1)) {
+        // Coup de l'agent, joué tel quel s'il est toujours libre ; le planificateur délaissé cesse de retenir le journal
+        caseVoisine(teteX, teteY, directionImposee, &prochainX, &prochainY);
+        serpent->planificateur.actif = false;
+    } else if (modeDetoursIncrementaux) {
+        planifierDetour(serpent, teteX, teteY, cibleX, cibleY, rapproche, plateau, occupation, &prochainX, &prochainY);
+    } else {
+        // Un détour en cours est poursuivi pour ne pas revenir buter sur le même corps
+        bool detourEnCours = cheminUtilisable(chemin, teteX, teteY, cibleX, cibleY, indiceSerpent, plateau, occupation);
+        if (detourEnCours || !rapproche) {
+            if (!detourEnCours) {
+                calculerChemin(teteX, teteY, cibleX, cibleY, indiceSerpent, plateau, occupation, chemin);
+            }
+
+            // Un chemin vide signifie que toutes les cases autour de la tête sont bloquées : le serpent reste sur place
+            prochainX = teteX;
+            prochainY = teteY;
+            if (chemin->etape < chemin->longueur) {
+                prochainX = chemin->lesX[chemin->etape];
+                prochainY = chemin->lesY[chemin->etape];
+                chemin->etape++;
+            }
+        }
+    }
+    // Une réservation ne doit pas immobiliser le serpent : faute de mieux, il entre dans la case libre la plus proche, même réservée
+    if (modeReservations && prochainX == teteX && prochainY == teteY && !(teteX == cibleX && teteY == cibleY)) {
+        short *distances = itineraire->lesChamps[serpent->rangPomme];
+        int libres = voisinsLibres(teteX, teteY, plateau, occupation);
+        int distanceMin = INFINI;
+        for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+            if (!((libres >> direction) & 1)) {
+                continue;
+            }
+            int voisinX, voisinY;
+            caseVoisine(teteX, teteY, direction, &voisinX, &voisinY);
+            int distance = distances[INDICE_CASE(voisinX, voisinY)];
+            if (distance == DISTANCE_INCONNUE) {
+                distance = INFINI - 1;
+            }
+            if (distance < distanceMin) {
+                distanceMin = distance;
+                prochainX = voisinX;
+                prochainY = voisinY;
+            }
+        }
+    }
+    ANNEAU(serpent, 0).x = prochainX;
+    ANNEAU(serpent, 0).y = prochainY;
+
+    // La tête occupe sa nouvelle case
+    deplacerAnneau(prochainX, prochainY, 1, occupation);
+    noterPassage(prochainX, prochainY, serpent, occupation);
+
+    // Vérifie si la tête du serpent atteint la pomme présente, qu'il la vise ou non
+    *pomme = (prochainX == itineraire->pommeX && prochainY == itineraire->pommeY);
+    if (*pomme) {
+        serpent->aGrandir += croissanceParPomme;
+        serpent->nbPommes++;
+    }
+
+    // L'ancienne tête devient un anneau du corps
+    afficher(teteX, teteY, CORPS);
+    afficher(prochainX, prochainY, TETE);
+
+    if (modeReservations) {
+        serpent->numeroPlan++;
+        // La pomme mangée, les champs de l'itinéraire seront décalés : le plan attend le prochain tour
+        if (!*pomme) {
+            reserverPlan(serpent, itineraire, cibleX, cibleY, plateau, occupation);
+        }
+    }
+}
+
+/**
+ * @brief Choisit la case voisine libre la plus proche de la pomme visée.
+ *
+ * Les cases aussi proches sont départagées par mieuxPlacee(). Une case
+ * réservée par un autre serpent au tour où la tête y entrerait est écartée
+ * (voir caseReservee()).
+ *
+ * @param serpent Le serpent.
+ * @param x Position X de la tête.
+ * @param y Position Y de la tête.
+ * @param tour Tour d'arrivée sur la case voisine (1 pour le pas joué maintenant).
+ * @param itineraire Champs de distances de la pomme visée et des suivantes.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ * @param prochainX Reçoit la position X de la case choisie, inchangée si aucune ne rapproche.
+ * @param prochainY Reçoit la position Y de la case choisie.
+ * @return true si une case voisine rapproche de la pomme.
+ */
+bool choisirVoisin(tSerpent *serpent, int x, int y, int tour, tItineraire *itineraire, tPlateau *plateau, tOccupation *occupation, int *prochainX, int *prochainY) {
+    short *distances = itineraire->lesChamps[serpent->rangPomme];
+    int indiceSerpent = (int)(serpent - occupation->lesSerpents);
+    int distanceMin = distances[INDICE_CASE(x, y)];
+    bool rapproche = false;
+    int libres = voisinsLibres(x, y, plateau, occupation);
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        if (!((libres >> direction) & 1)) {
+            continue;
+        }
+        int voisinX, voisinY;
+        caseVoisine(x, y, direction, &voisinX, &voisinY);
+        int distance = distances[INDICE_CASE(voisinX, voisinY)];
+        if (((distance != DISTANCE_INCONNUE && (distanceMin == DISTANCE_INCONNUE || distance < distanceMin))
+             || (rapproche && distance == distanceMin
+                 && mieuxPlacee(itineraire, serpent->rangPomme, INDICE_CASE(voisinX, voisinY), INDICE_CASE(*prochainX, *prochainY), distance, serpent->taille + serpent->aGrandir)))
+            && !caseReservee(voisinX, voisinY, indiceSerpent, tour, occupation)) {
+            distanceMin = distance;
+            *prochainX = voisinX;
+            *prochainY = voisinY;
+            rapproche = true;
+        }
+    }
+    return rapproche;
+}
+
+/**
+ * @brief Réserve les FENETRE_RESERVATIONS prochains pas d'un serpent qui vient de jouer.
+ *
+ * Réservation coopérative à fenêtre (WHCA*) : les serpents planifient l'un
+ * après l'autre, et chacun contourne les cases que les plans des autres
+ * occupent aux mêmes tours. Le plan suit le détour en cours s'il y en a un,
+ * sinon la descente du champ de distances que choisirVoisin() jouerait sur
+ * l'occupation actuelle. Il s'arrête à la première case déjà réservée par un
+ * autre serpent ou à la cible : les pas suivants ne sont pas réservés.
+ *
+ * Les anciennes réservations du serpent ont été périmées par le changement de
+ * numeroPlan ; le plan est refait à chaque tour, si bien qu'une réservation ne
+ * vit jamais plus d'un tour sans être confirmée.
+ *
+ * @param serpent Le serpent, numeroPlan déjà avancé.
+ * @param itineraire Champs de distances de la pomme visée et des suivantes.
+ * @param cibleX Position X de la cible.
+ * @param cibleY Position Y de la cible.
+ * @param plateau Le plateau de jeu.
+ * @param occupation Occupation des serpents.
+ */
+void reserverPlan(tSerpent *serpent, tItineraire *itineraire, int cibleX, int cibleY, tPlateau *plateau, tOccupation *occupation) {
+    tChemin *chemin = &serpent->chemin;
+    int indiceSerpent = (int)(serpent - occupation->lesSerpents);
+    int x = ANNEAU(serpent, 0).x, y = ANNEAU(serpent, 0).y;
+    bool detour = cheminUtilisable(chemin, x, y, cibleX, cibleY, indiceSerpent, plateau, occupation);
+
+    for (int tour = 1; tour <= FENETRE_RESERVATIONS && !(x == cibleX && y == cibleY); tour++) {
+        int prochainX = x, prochainY = y;
+        if (detour) {
+            if (chemin->etape + tour - 1 >= chemin->longueur) {
+                break;
+            }
+            prochainX = chemin->lesX[chemin->etape + tour - 1];
+            prochainY = chemin->lesY[chemin->etape + tour - 1];
+        } else if (!choisirVoisin(serpent, x, y, tour, itineraire, plateau, occupation, &prochainX, &prochainY)) {
+            break;
+        }
+        if (!reserverCase(prochainX, prochainY, indiceSerpent, tour, occupation)) {
+            break;
+        }
+        x = prochainX;
+        y = prochainY;
+    }
+}
+
+/**
+ * @brief Alloue les arbres de l'agent MCTS, une fois pour toute la partie.
+ *
+ * @param agent L'agent à créer.
+ * @param nbFils Nombre de fils d'exécution, chacun avec son arbre.
+ */
+void creerAgentMcts(tAgentMcts *agent, int nbFils) {
+    agent->nbArbres = nbFils;
+    agent->lesArbres = calloc(nbFils, sizeof(tArbreMcts));
+    if (agent->lesArbres == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < nbFils; i++) {
+        agent->lesArbres[i].lesNoeuds = malloc(NOEUDS_MCTS * sizeof(tNoeudMcts));
+        if (agent->lesArbres[i].lesNoeuds == NULL) {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+        agent->lesArbres[i].contexte = &agent->contexte;
+        initialiserAleatoire(&agent->lesArbres[i].aleatoire, (uint64_t)i + 1);
+    }
+}
+
+/**
+ * @brief Libère les arbres de l'agent MCTS.
+ *
+ * @param agent L'agent à détruire.
+ */
+void detruireAgentMcts(tAgentMcts *agent) {
+    for (int i = 0; i < agent->nbArbres; i++) {
+        free(agent->lesArbres[i].lesNoeuds);
+    }
+    free(agent->lesArbres);
+}
+
+/**
+ * @brief Résume les deux serpents de la partie dans un état compact.
+ *
+ * Les anneaux superposés d'un serpent resté sur place ne comptent qu'une fois.
+ * Au-delà de ANNEAUX_MCTS anneaux, la fin du corps est ignorée : l'agent peut
+ * alors choisir un coup bloqué, que progresser() remplace par le sien.
+ *
+ * @param etat Reçoit l'état compact, premier serpent au trait.
+ * @param lesSerpents Les deux serpents de la partie.
+ * @param indexPomme Indice de la pomme présente.
+ */
+void lireEtatMcts(tEtatMcts *etat, tSerpent lesSerpents[], int indexPomme) {
+    memset(etat, 0, sizeof(*etat));
+    etat->indexPomme = (uint8_t)indexPomme;
+    for (int s = 0; s < 2; s++) {
+        tSerpent *serpent = &lesSerpents[s];
+        tAnneau precedent = ANNEAU(serpent, 0);
+        int nbAnneaux = 1;
+
+        etat->teteX[s] = precedent.x;
+        etat->teteY[s] = precedent.y;
+        etat->aGrandir[s] = (serpent->aGrandir > UINT16_MAX) ? UINT16_MAX : (uint16_t)serpent->aGrandir;
+        for (int i = 1; i < serpent->taille && nbAnneaux < ANNEAUX_MCTS; i++) {
+            tAnneau anneau = ANNEAU(serpent, i);
+            if (anneau.x == precedent.x && anneau.y == precedent.y) {
+                continue;
+            }
+            int direction = 0, voisinX, voisinY;
+            for (; direction < NB_DIRECTIONS; direction++) {
+                caseVoisine(precedent.x, precedent.y, direction, &voisinX, &voisinY);
+                if (voisinX == anneau.x && voisinY == anneau.y) {
+                    break;
+                }
+            }
+            if (direction == NB_DIRECTIONS) {
+                break;
+            }
+            etat->corps[s][(nbAnneaux - 1) / 32] |= (uint64_t)direction << (2 * ((nbAnneaux - 1) % 32));
+            precedent = anneau;
+            nbAnneaux++;
+        }
+        etat->taille[s] = (uint8_t)nbAnneaux;
+    }
+}
+
+/**
+ * @brief Indique quelles cases voisines d'une case sont occupées par les premiers anneaux d'un serpent de l'état compact.
+ *
+ * Le corps n'est parcouru qu'une fois pour les quatre voisines, et pas du
+ * tout quand la tête est trop loin pour que le corps les atteigne.
+ *
+ * @param etat L'état compact.
+ * @param serpent Indice du serpent (0 ou 1).
+ * @param nbAnneaux Nombre d'anneaux examinés depuis la tête.
+ * @param lesVoisinsX Positions X des NB_DIRECTIONS cases voisines.
+ * @param lesVoisinsY Positions Y des cases voisines.
+ * @return Masque de NB_DIRECTIONS bits : le bit d est à 1 si la voisine d est occupée.
+ */
+int voisinsOccupesMcts(const tEtatMcts *etat, int serpent, int nbAnneaux, const int lesVoisinsX[], const int lesVoisinsY[]) {
+    int anneauX = etat->teteX[serpent], anneauY = etat->teteY[serpent];
+    int occupes = 0;
+
+    // L'anneau k est à k pas au plus de la tête, portails compris : des voisines plus éloignées ne peuvent pas être atteintes
+    int ecartX = abs(lesVoisinsX[0] - anneauX), ecartY = abs(lesVoisinsY[0] - anneauY);
+    if (ecartX > largeurPlateau / 2) {
+        ecartX = largeurPlateau - ecartX;
+    }
+    if (ecartY > hauteurPlateau / 2) {
+        ecartY = hauteurPlateau - ecartY;
+    }
+    if (ecartX + ecartY > nbAnneaux + 1) {
+        return 0;
+    }
+
+    for (int k = 0; k < nbAnneaux; k++) {
+        for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+            if (anneauX == lesVoisinsX[direction] && anneauY == lesVoisinsY[direction]) {
+                occupes |= 1 << direction;
+            }
+        }
+        caseVoisine(anneauX, anneauY, (int)((etat->corps[serpent][k / 32] >> (2 * (k % 32))) & 3), &anneauX, &anneauY);
+    }
+    return occupes;
+}
+
+/**
+ * @brief Énumère les coups possibles du serpent au trait.
+ *
+ * Comme dans progresser(), la queue du serpent au trait libère sa case avant
+ * que la tête avance, sauf s'il grandit.
+ *
+ * @param etat L'état compact.
+ * @param plateau Le plateau de jeu.
+ * @param lesCoups Reçoit les directions possibles (au plus NB_DIRECTIONS).
+ * @return Le nombre de coups possibles, 0 si le serpent est bloqué.
+ */
+int coupsMcts(const tEtatMcts *etat, tPlateau *plateau, int lesCoups[]) {
+    int joueur = etat->joueur, autre = 1 - joueur;
+    int anneauxJoueur = etat->taille[joueur] - ((etat->aGrandir[joueur] == 0) ? 1 : 0);
+    int lesVoisinsX[NB_DIRECTIONS], lesVoisinsY[NB_DIRECTIONS];
+    int bloques = 0, nbCoups = 0;
+
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        caseVoisine(etat->teteX[joueur], etat->teteY[joueur], direction, &lesVoisinsX[direction], &lesVoisinsY[direction]);
+        bloques |= caseObstacle(lesVoisinsX[direction], lesVoisinsY[direction], plateau) << direction;
+    }
+    bloques |= voisinsOccupesMcts(etat, joueur, anneauxJoueur, lesVoisinsX, lesVoisinsY);
+    bloques |= voisinsOccupesMcts(etat, autre, etat->taille[autre], lesVoisinsX, lesVoisinsY);
+    for (int direction = 0; direction < NB_DIRECTIONS; direction++) {
+        if (!((bloques >> direction) & 1)) {
+            lesCoups[nbCoups++] = direction;
+        }
+    }
+    return nbCoups;
+}
+
+/**
+ * @brief Joue un coup du serpent au trait dans l'état compact, puis passe le trait.
+ *
+ * @param etat L'état compact.
+ * @param direction Direction du coup, AUCUNE_DIRECTION pour un serpent bloqué qui reste sur place.
+ * @param contexte Réflexion en cours (positions des pommes).
+ */
+void jouerCoupMcts(tEtatMcts *etat, int direction, tContexteMcts *contexte) {
+    int joueur = etat->joueur;
+    if (direction != AUCUNE_DIRECTION) {
+        int teteX, teteY;
+        if (etat->aGrandir[joueur] > 0) {
+            etat->aGrandir[joueur]--;
+            if (etat->taille[joueur] < ANNEAUX_MCTS) {
+                etat->taille[joueur]++;
+            }
+        }
+        // L'ancienne tête devient le deuxième anneau, dans la direction opposée au coup
+        uint64_t *corps = etat->corps[joueur];
+        corps[1] = (corps[1] << 2) | (corps[0] >> 62);
+        corps[0] = (corps[0] << 2) | (uint64_t)DIRECTION_OPPOSEE(direction);
+        caseVoisine(etat->teteX[joueur], etat->teteY[joueur], direction, &teteX, &teteY);
+        etat->teteX[joueur] = (uint16_t)teteX;
+        etat->teteY[joueur] = (uint16_t)teteY;
+
+        if (etat->indexPomme < NB_POMMES && teteX == contexte->lesPommesX[etat->indexPomme] && teteY == contexte->lesPommesY[etat->indexPomme]) {
+            etat->pommes[joueur]++;
+            etat->indexPomme++;
+            etat->aGrandir[joueur] = (etat->aGrandir[joueur] + croissanceParPomme > UINT16_MAX) ? UINT16_MAX : (uint16_t)(etat->aGrandir[joueur] + croissanceParPomme);
+        }
+    }
+    etat->joueur = (uint8_t)(1 - joueur);
+    etat->profondeur++;
+}
+
+/**
+ * @brief Indique si une simulation s'arrête sur un état.
+ *
+ * La simulation s'arrête à HORIZON_MCTS coups de la racine, quand toutes les
+ * pommes sont mangées, ou quand la pomme présente sort de l'itinéraire, faute
+ * de champ de distances pour la viser.
+ *
+ * @param etat L'état compact.
+ * @param contexte Réflexion en cours.
+ * @return true si l'état termine la simulation.
+ */
+bool finMcts(const tEtatMcts *etat, tContexteMcts *contexte) {
+    return etat->profondeur >= HORIZON_MCTS || etat->indexPomme >= NB_POMMES
+           || etat->indexPomme - contexte->itineraire->premiere >= contexte->itineraire->nbChamps;
+}
+
+/**
+ * @brief Termine une partie au hasard depuis un état et l'évalue.
+ *
+ * Les deux serpents jouent la politique gloutonne de progresser() : chacun
+ * descend le champ de distances de la pomme présente, les cases aussi proches
+ * étant départagées au hasard, et un coup sur huit est tiré au hasard parmi
+ * les coups possibles. Aucune recherche de détour n'est menée.
+ *
+ * Le résultat est l'écart de pommes mangées depuis la racine, en faveur du
+ * premier serpent ; à écart égal, le serpent le plus proche de la pomme
+ * présente à la fin de la simulation l'emporte d'une fraction de pomme.
+ *
+ * @param etat État de départ, joué jusqu'à la fin de la simulation.
+ * @param contexte Réflexion en cours.
+ * @param aleatoire Générateur du fil.
+ * @return Le résultat de la simulation pour le premier serpent.
+ */
+double simulerMcts(tEtatMcts *etat, tContexteMcts *contexte, tAleatoire *aleatoire) {
+    tItineraire *itineraire = contexte->itineraire;
+
+    while (!finMcts(etat, contexte)) {
+        int lesCoups[NB_DIRECTIONS];
+        int nbCoups = coupsMcts(etat, contexte->plateau, lesCoups);
+        int direction = AUCUNE_DIRECTION;
+        if (nbCoups > 0) {
+            uint64_t tirage = tirerAleatoire(aleatoire);
+            if ((tirage & 7) == 0) {
+                direction = lesCoups[(tirage >> 3) % (uint64_t)nbCoups];
+            } else {
+                short *distances = itineraire->lesChamps[etat->indexPomme - itineraire->premiere];
+                int distanceMin = INFINI, nbEgales = 0;
+                for (int i = 0; i < nbCoups; i++) {
+                    int voisinX, voisinY;
+                    caseVoisine(etat->teteX[etat->joueur], etat->teteY[etat->joueur], lesCoups[i], &voisinX, &voisinY);
+                    int distance = distances[INDICE_CASE(voisinX, voisinY)];
+                    if (distance == DISTANCE_INCONNUE) {
+                        distance = INFINI - 1;
+                    }
+                    if (distance < distanceMin) {
+                        distanceMin = distance;
+                        direction = lesCoups[i];
+                        nbEgales = 1;
+                    } else if (distance == distanceMin && ((tirage >> (8 * (i + 1))) & 0xFF) % ++nbEgales == 0) {
+                        direction = lesCoups[i];
+                    }
+                }
+            }
+        }
+        jouerCoupMcts(etat, direction, contexte);
+    }
+
+    double resultat = (double)etat->pommes[0] - etat->pommes[1];
+    int rang = etat->indexPomme - itineraire->premiere;
+    if (etat->indexPomme < NB_POMMES && rang < itineraire->nbChamps) {
+        short *distances = itineraire->lesChamps[rang];
+        int lesDistances[2];
+        for (int s = 0; s < 2; s++) {
+            lesDistances[s] = distances[INDICE_CASE(etat->teteX[s], etat->teteY[s])];
+            if (lesDistances[s] == DISTANCE_INCONNUE) {
+                lesDistances[s] = largeurPlateau + hauteurPlateau;
+            }
+        }
+        resultat += (double)(lesDistances[1] - lesDistances[0]) / (largeurPlateau + hauteurPlateau);
+    }
+    return resultat;
+}
+
+/**
+ * @brief Choisit le fils à explorer d'un nœud développé (formule UCB1).
+ *
+ * Les fils jamais visités passent d'abord ; ensuite, le fils qui maximise son
+ * gain moyen pour le serpent qui joue son coup, augmenté d'un bonus
+ * d'exploration qui décroît avec ses visites.
+ *
+ * @param arbre L'arbre du fil.
+ * @param noeud Indice du nœud développé.
+ * @return Indice du fils choisi.
+ */
+int choisirFilsMcts(tArbreMcts *arbre, int noeud) {
+    tNoeudMcts *parent = &arbre->lesNoeuds[noeud];
+    double logVisites = log(parent->visites > 0 ? parent->visites : 1);
+    int meilleur = parent->premierFils;
+    double scoreMax = 0.0;
+    for (int i = 0; i < parent->nbFils; i++) {
+        tNoeudMcts *fils = &arbre->lesNoeuds[parent->premierFils + i];
+        if (fils->visites == 0) {
+            return parent->premierFils + i;
+        }
+        double score = fils->gains / fils->visites + EXPLORATION_MCTS * sqrt(logVisites / fils->visites);
+        if (i == 0 || score > scoreMax) {
+            scoreMax = score;
+            meilleur = parent->premierFils + i;
+        }
+    }
+    return meilleur;
+}
+
+/**
+ * @brief Développe l'arbre d'un fil jusqu'à l'échéance de la réflexion.
+ *
+ * Chaque simulation rejoue l'état depuis la racine en descendant l'arbre
+ * (choisirFilsMcts()), développe la feuille atteinte avec tous ses coups,
+ * termine la partie avec simulerMcts() puis remonte le résultat jusqu'à la
+ * racine. Les serpents jouent à tour de rôle, comme dans jouerTour() : chaque
+ * nœud compte le résultat du point de vue du serpent qui a joué son coup. Une
+ * fois l'arbre plein, les feuilles ne sont plus développées mais les
+ * simulations continuent.
+ *
+ * @param donnees L'arbre du fil (tArbreMcts).
+ * @return NULL.
+ */
+void *explorerMcts(void *donnees) {
+    tArbreMcts *arbre = donnees;
+    tContexteMcts *contexte = arbre->contexte;
+    int leChemin[HORIZON_MCTS + 2];
+    int lesJoueurs[HORIZON_MCTS + 2];
+    struct timespec maintenant;
+
+    arbre->nbNoeuds = 1;
+    arbre->lesNoeuds[0] = (tNoeudMcts){-1, 0, 0.0f, 0, AUCUNE_DIRECTION};
+    for (long simulation = 0;; simulation++) {
+        // L'horloge n'est lue que toutes les 32 simulations
+        if (simulation % 32 == 0) {
+            clock_gettime(CLOCK_MONOTONIC, &maintenant);
+            if (dureeNanosecondes(contexte->echeance, maintenant) >= 0) {
+                break;
+            }
+        }
+
+        tEtatMcts etat = contexte->racine;
+        int noeud = 0, longueur = 1;
+        leChemin[0] = 0;
+        lesJoueurs[0] = -1;
+        while (arbre->lesNoeuds[noeud].premierFils != -1) {
+            noeud = choisirFilsMcts(arbre, noeud);
+            lesJoueurs[longueur] = etat.joueur;
+            leChemin[longueur++] = noeud;
+            jouerCoupMcts(&etat, arbre->lesNoeuds[noeud].direction, contexte);
+        }
+
+        if (!finMcts(&etat, contexte) && arbre->nbNoeuds + NB_DIRECTIONS <= NOEUDS_MCTS) {
+            int lesCoups[NB_DIRECTIONS];
+            int nbCoups = coupsMcts(&etat, contexte->plateau, lesCoups);
+            if (nbCoups == 0) {
+                lesCoups[nbCoups++] = AUCUNE_DIRECTION;
+            }
+            arbre->lesNoeuds[noeud].premierFils = arbre->nbNoeuds;
+            arbre->lesNoeuds[noeud].nbFils = (int8_t)nbCoups;
+            for (int i = 0; i < nbCoups; i++) {
+                arbre->lesNoeuds[arbre->nbNoeuds++] = (tNoeudMcts){-1, 0, 0.0f, 0, (int8_t)lesCoups[i]};
+            }
+            noeud = arbre->lesNoeuds[noeud].premierFils;
+            lesJoueurs[longueur] = etat.joueur;
+            leChemin[longueur++] = noeud;
+            jouerCoupMcts(&etat, lesCoups[0], contexte);
+        }
+
+        double resultat = simulerMcts(&etat, contexte, &arbre->aleatoire);
+        for (int i = 0; i < longueur; i++) {
+            tNoeudMcts *visite = &arbre->lesNoeuds[leChemin[i]];
+            visite->visites++;
+            visite->gains += (float)((lesJoueurs[i] == 1) ? -resultat : resultat);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Choisit le coup du premier serpent par recherche arborescente Monte-Carlo.
+ *
+ * La partie est résumée dans un état compact (voir tEtatMcts) que chaque
+ * simulation copie sans allocation. Chacun des fils d'exécution de l'agent
+ * développe son propre arbre depuis cet état (voir explorerMcts()) pendant
+ * budgetMcts millisecondes ; les visites des coups de la racine sont ensuite
+ * additionnées sur tous les arbres, et le coup le plus visité est joué. Un
+ * serpent qui n'a qu'un coup possible le joue sans réfléchir.
+ *
+ * L'agent vise la pomme présente et joue contre le second serpent, qui reste
+ * glouton ; il est donc incompatible avec l'option --cooperatif, refusée par
+ * main().
+ *
+ * @param agent L'agent MCTS.
+ * @param lesSerpents Les deux serpents de la partie, le premier au trait.
+ * @param indexPomme Indice de la pomme présente.
+ * @param plateau Le plateau de jeu.
+ * @param itineraire Champs de distances de la pomme présente et des suivantes.
+ * @param lesPommesX Positions X des pommes.
+ * @param lesPommesY Positions Y des pommes.
+ * @return La direction choisie, AUCUNE_DIRECTION si le serpent est bloqué.
+ */
+int deciderMcts(tAgentMcts *agent, tSerpent lesSerpents[], int indexPomme, tPlateau *plateau, tItineraire *itineraire, int lesPommesX[], int lesPommesY[]) {
+    tContexteMcts *contexte = &agent->contexte;
+    int lesCoups[NB_DIRECTIONS];
+    int lesVisites[NB_DIRECTIONS] = {0};
+
+    lireEtatMcts(&contexte->racine, lesSerpents, indexPomme);
+    contexte->plateau = plateau;
+    contexte->itineraire = itineraire;
+    contexte->lesPommesX = lesPommesX;
+    contexte->lesPommesY = lesPommesY;
+    int nbCoups = coupsMcts(&contexte->racine, plateau, lesCoups);
+    if (nbCoups <= 1) {
+        return (nbCoups == 1) ? lesCoups[0] : AUCUNE_DIRECTION;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &contexte->echeance);
+    contexte->echeance.tv_nsec += (long)budgetMcts * 1000000L;
+    contexte->echeance.tv_sec += contexte->echeance.tv_nsec / 1000000000L;
+    contexte->echeance.tv_nsec %= 1000000000L;
+
+    for (int i = 0; i < agent->nbArbres; i++) {
+        int erreur = pthread_create(&agent->lesArbres[i].fil, NULL, explorerMcts, &agent->lesArbres[i]);
+        if (erreur != 0) {
+            errno = erreur;
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < agent->nbArbres; i++) {
+        pthread_join(agent->lesArbres[i].fil, NULL);
+        tNoeudMcts *racine = &agent->lesArbres[i].lesNoeuds[0];
+        for (int j = 0; j < racine->nbFils; j++) {
+            tNoeudMcts *fils = &agent->lesArbres[i].lesNoeuds[racine->premierFils + j];
+            lesVisites[fils->direction] += fils->visites;
+        }
+    }
+
+    int meilleur = lesCoups[0];
+    for (int i = 1; i < nbCoups; i++) {
+        if (lesVisites[lesCoups[i]] > lesVisites[meilleur]) {
+            meilleur = lesCoups[i];
+        }
+    }
+    return meilleur;
+}
+
+/**
+ * @brief Alloue la table de transposition et les chercheurs de l'agent alpha-bêta, une fois pour toute la partie.
+ *
+ * La table est conservée d'un tour à l'autre : les positions déjà analysées
+ * au tour précédent orientent l'ordre des coups du suivant.
+ *
+ * @param agent L'agent à créer.
+ * @param nbFils Nombre de fils d'exécution.
+ */
+void creerAgentAlphaBeta(tAgentAlphaBeta *agent, int nbFils) {
+    agent->nbChercheurs = nbFils;
+    agent->lesEntrees = calloc(ENTREES_TRANSPOSITION, sizeof(tEntreeTransposition));
+    agent->lesChercheurs = calloc(nbFils, sizeof(tChercheurAlphaBeta));
+    if (agent->lesEntrees == NULL || agent->lesChercheurs == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < nbFils; i++) {
+        agent->lesChercheurs[i].agent = agent;
+        // Les fils auxiliaires commencent un ou deux niveaux plus bas pour ne pas refaire les mêmes itérations
+        agent->lesChercheurs[i].premiereProfondeur = (i == 0) ? 1 : 2 + (i + 1) % 2;
+    }
+}
+
+/**
+ * @brief Libère la table de transposition et les chercheurs de l'agent alpha-bêta.
+ *
+ * @param agent L'agent à détruire.
+ */
+void detruireAgentAlphaBeta(tAgentAlphaBeta *agent) {
+    free(agent->lesEntrees);
+    free(agent->lesChercheurs);
+}
+
+/**
+ * @brief Nombre aléatoire de Zobrist d'un élément de position.
+ *
+ * Les plateaux pouvant compter des millions de cases, les nombres ne sont pas
+ * tirés dans une table mais calculés par mélange de l'élément et de sa valeur
+ * (fonction de finalisation de splitmix64) : le résultat est le même à chaque
+ * appel et se comporte comme un tirage indépendant.
+ *
+ * @param element Élément de la position (ZOBRIST_CORPS, ZOBRIST_TETE...), le serpent compris.
+ * @param valeur Valeur de l'élément (indice de case, nombre d'anneaux, indice de pomme).
+ * @return Le nombre de Zobrist de l'élément pour cette valeur.
+ */
+uint64_t cleZobrist(int element, int valeur) {
+    uint64_t z = ((uint64_t)element << 40) ^ (uint64_t)(uint32_t)valeur;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Position d'un anneau d'un serpent de l'état compact.
+ *
+ * @param etat L'état compact.
+ * @param serpent Indice du serpent (0 ou 1).
+ * @param k Rang de l'anneau depuis la tête (0 pour la tête), inférieur à la taille du serpent.
+ * @param x Reçoit la position X de l'anneau.
+ * @param y Reçoit la position Y de l'anneau.
+ */
+void anneauMcts(const tEtatMcts *etat, int serpent, int k, int *x, int *y) {
+    int anneauX = etat->teteX[serpent], anneauY = etat->teteY[serpent];
+    for (int i = 0; i < k; i++) {
+        caseVoisine(anneauX, anneauY, (int)((etat->corps[serpent][i / 32] >> (2 * (i % 32))) & 3), &anneauX, &anneauY);
+    }
+    *x = anneauX;
+    *y = anneauY;
+}
+
+/**
+ * @brief Calcule la clé Zobrist d'un état compact.
+ *
+ * La clé combine par XOR les nombres de Zobrist de chaque anneau et de la
+ * tête des deux serpents, de leurs anneaux restant à gagner, de la pomme
+ * présente et du serpent au trait. Le plateau ne change pas pendant la partie
+ * et n'y entre pas. La recherche la met ensuite à jour coup par coup (voir
+ * jouerCoupAlphaBeta()).
+ *
+ * @param etat L'état compact.
+ * @return La clé de l'état.
+ */
+uint64_t clePosition(const tEtatMcts *etat) {
+    uint64_t cle = cleZobrist(ZOBRIST_POMME, etat->indexPomme);
+    if (etat->joueur == 1) {
+        cle ^= cleZobrist(ZOBRIST_TRAIT, 0);
+    }
+    for (int s = 0; s < 2; s++) {
+        int anneauX = etat->teteX[s], anneauY = etat->teteY[s];
+        cle ^= cleZobrist(ZOBRIST_TETE + s, INDICE_CASE(anneauX, anneauY));
+        cle ^= cleZobrist(ZOBRIST_GRANDIR + s, etat->aGrandir[s]);
+        for (int k = 0; k < etat->taille[s]; k++) {
+            cle ^= cleZobrist(ZOBRIST_CORPS + s, INDICE_CASE(anneauX, anneauY));
+            caseVoisine(anneauX, anneauY, (int)((etat->corps[s][k / 32] >> (2 * (k % 32))) & 3), &anneauX, &anneauY);
+        }
+    }
+    return cle;
+}
+
+/**
+ * @brief Joue un coup dans l'état compact en mettant sa clé Zobrist à jour.
+ *
+ * Seuls les éléments qui changent sont retirés puis ajoutés à la clé : la
+ * tête, la queue quand elle avance, les anneaux restant à gagner, la pomme
+ * présente et le trait.
+ *
+ * @param etat L'état compact, joué comme par jouerCoupMcts().
+ * @param cle Clé de l'état avant le coup.
+ * @param direction Direction du coup, AUCUNE_DIRECTION pour un serpent bloqué.
+ * @param contexte Réflexion en cours (positions des pommes).
+ * @return La clé de l'état après le coup.
+ */
+uint64_t jouerCoupAlphaBeta(tEtatMcts *etat, uint64_t cle, int direction, tContexteMcts *contexte) {
+    int joueur = etat->joueur;
+    int indexPomme = etat->indexPomme;
+
+    cle ^= cleZobrist(ZOBRIST_TRAIT, 0);
+    if (direction != AUCUNE_DIRECTION) {
+        // La queue quitte sa case si le serpent ne grandit pas, ou s'il a déjà ANNEAUX_MCTS anneaux retenus
+        if (etat->aGrandir[joueur] == 0 || etat->taille[joueur] == ANNEAUX_MCTS) {
+            int queueX, queueY;
+            anneauMcts(etat, joueur, etat->taille[joueur] - 1, &queueX, &queueY);
+            cle ^= cleZobrist(ZOBRIST_CORPS + joueur, INDICE_CASE(queueX, queueY));
+        }
+        cle ^= cleZobrist(ZOBRIST_TETE + joueur, INDICE_CASE(etat->teteX[joueur], etat->teteY[joueur]));
+        cle ^= cleZobrist(ZOBRIST_GRANDIR + joueur, etat->aGrandir[joueur]);
+    }
+    jouerCoupMcts(etat, direction, contexte);
+    if (direction != AUCUNE_DIRECTION) {
+        int tete = INDICE_CASE(etat->teteX[joueur], etat->teteY[joueur]);
+        cle ^= cleZobrist(ZOBRIST_CORPS + joueur, tete) ^ cleZobrist(ZOBRIST_TETE + joueur, tete);
+        cle ^= cleZobrist(ZOBRIST_GRANDIR + joueur, etat->aGrandir[joueur]);
+        if (etat->indexPomme != indexPomme) {
+            cle ^= cleZobrist(ZOBRIST_POMME, indexPomme) ^ cleZobrist(ZOBRIST_POMME, etat->indexPomme);
+        }
+    }
+    return cle;
+}
+
+/**
+ * @brief Indique si la recherche alpha-bêta doit évaluer un état sans le développer.
+ *
+ * C'est le cas quand toutes les pommes sont mangées, ou quand la pomme
+ * présente sort de l'itinéraire, faute de champ de distances pour l'évaluer.
+ *
+ * @param etat L'état compact.
+ * @param contexte Réflexion en cours.
+ * @return true si l'état est une feuille.
+ */
+bool feuilleAlphaBeta(const tEtatMcts *etat, tContexteMcts *contexte) {
+    return etat->indexPomme >= NB_POMMES || etat->indexPomme - contexte->itineraire->premiere >= contexte->itineraire->nbChamps;
+}
+
+/**
+ * @brief Évalue un état du point de vue du serpent au trait.
+ *
+ * Chaque pomme d'avance depuis la racine vaut POINTS_POMME ; à écart égal,
+ * chaque pas d'avance vers la pomme présente, selon son champ de distances,
+ * vaut un point.
+ *
+ * @param etat L'état compact.
+ * @param contexte Réflexion en cours.
+ * @return Le score entier de l'état pour le serpent au trait.
+ */
+int evaluerAlphaBeta(const tEtatMcts *etat, tContexteMcts *contexte) {
+    tItineraire *itineraire = contexte->itineraire;
+    int joueur = etat->joueur, autre = 1 - joueur;
+    int score = POINTS_POMME * (etat->pommes[joueur] - etat->pommes[autre]);
+
+    if (!feuilleAlphaBeta(etat, contexte)) {
+        short *distances = itineraire->lesChamps[etat->indexPomme - itineraire->premiere];
+        int lesDistances[2];
+        for (int s = 0; s < 2; s++) {
+            lesDistances[s] = distances[INDICE_CASE(etat->teteX[s], etat->teteY[s])];
+            if (lesDistances[s] == DISTANCE_INCONNUE) {
+                lesDistances[s] = largeurPlateau + hauteurPlateau;
+            }
+        }
+        score += lesDistances[autre] - lesDistances[joueur];
+    }
+    return score;
+}
+
+/**
+ * @brief Trie les coups du serpent au trait, les plus prometteurs d'abord.
+ *
+ * Le meilleur coup retenu par la table de transposition passe en tête ; les
+ * autres suivent par distance croissante à la pomme présente, selon
+ * calculerDistanceOptimale(), ce qui provoque les coupures au plus tôt.
+ *
+ * @param etat L'état compact.
+ * @param contexte Réflexion en cours.
+ * @param lesCoups Les coups possibles, triés en place.
+ * @param nbCoups Le nombre de coups.
+ * @param coupPrefere Meilleur coup de la table de transposition, AUCUNE_DIRECTION sinon.
+ */
+void ordonnerCoups(const tEtatMcts *etat, tContexteMcts *contexte, int lesCoups[], int nbCoups, int coupPrefere) {
+    int lesCles[NB_DIRECTIONS];
+    bool reste = etat->indexPomme < NB_POMMES;
+
+    for (int i = 0; i < nbCoups; i++) {
+        int voisinX, voisinY, portailX, portailY;
+        bool utilisePortail;
+        caseVoisine(etat->teteX[etat->joueur], etat->teteY[etat->joueur], lesCoups[i], &voisinX, &voisinY);
+        if (lesCoups[i] == coupPrefere) {
+            lesCles[i] = -1;
+        } else if (reste) {
+            lesCles[i] = calculerDistanceOptimale(voisinX, voisinY, contexte->lesPommesX[etat->indexPomme], contexte->lesPommesY[etat->indexPomme],
+                                                  &portailX, &portailY, &utilisePortail);
+        } else {
+            lesCles[i] = 0;
+        }
+        // Tri par insertion : quatre coups au plus
+        for (int j = i; j > 0 && lesCles[j] < lesCles[j - 1]; j--) {
+            int cle = lesCles[j], coup = lesCoups[j];
+            lesCles[j] = lesCles[j - 1];
+            lesCoups[j] = lesCoups[j - 1];
+            lesCles[j - 1] = cle;
+            lesCoups[j - 1] = coup;
+        }
+    }
+}
+
+/**
+ * @brief Cherche une position dans la table de transposition.
+ *
+ * @param agent L'agent alpha-bêta.
+ * @param cle Clé Zobrist de la position.
+ * @param score Reçoit le score rangé, relatif aux pommes déjà mangées (voir chercherAlphaBeta()).
+ * @param profondeur Reçoit la profondeur de la recherche qui a donné ce score.
+ * @param borne Reçoit BORNE_EXACTE, BORNE_INFERIEURE ou BORNE_SUPERIEURE.
+ * @param coup Reçoit le meilleur coup trouvé, AUCUNE_DIRECTION si aucun.
+ * @return true si la position est dans la table.
+ */
+bool lireTransposition(tAgentAlphaBeta *agent, uint64_t cle, int *score, int *profondeur, int *borne, int *coup) {
+    tEntreeTransposition *entree = &agent->lesEntrees[cle & (ENTREES_TRANSPOSITION - 1)];
+    uint64_t verrou = atomic_load_explicit(&entree->verrou, memory_order_relaxed);
+    uint64_t donnees = atomic_load_explicit(&entree->donnees, memory_order_relaxed);
+
+    if ((verrou ^ donnees) != cle || donnees == 0) {
+        return false;
+    }
+    *score = (int32_t)(uint32_t)donnees;
+    *profondeur = (int)((donnees >> 32) & 0xFF);
+    *borne = (int)((donnees >> 40) & 3);
+    *coup = (int)((donnees >> 42) & 7) - 1;
+    return true;
+}
+
+/**
+ * @brief Range le résultat d'une recherche dans la table de transposition.
+ *
+ * Une entrée n'est remplacée par la même position que si la nouvelle
+ * recherche est au moins aussi profonde ; une autre position la remplace
+ * toujours. Le score, la profondeur, la borne et le coup tiennent dans un mot
+ * de 64 bits, jamais nul.
+ *
+ * @param agent L'agent alpha-bêta.
+ * @param cle Clé Zobrist de la position.
+ * @param score Score relatif aux pommes déjà mangées.
+ * @param profondeur Profondeur de la recherche.
+ * @param borne BORNE_EXACTE, BORNE_INFERIEURE ou BORNE_SUPERIEURE.
+ * @param coup Meilleur coup trouvé, AUCUNE_DIRECTION si aucun.
+ */
+void rangerTransposition(tAgentAlphaBeta *agent, uint64_t cle, int score, int profondeur, int borne, int coup) {
+    tEntreeTransposition *entree = &agent->lesEntrees[cle & (ENTREES_TRANSPOSITION - 1)];
+    uint64_t ancien = atomic_load_explicit(&entree->donnees, memory_order_relaxed);
+
+    if ((atomic_load_explicit(&entree->verrou, memory_order_relaxed) ^ ancien) == cle && (int)((ancien >> 32) & 0xFF) > profondeur) {
+        return;
+    }
+    uint64_t donnees = (uint64_t)(uint32_t)score | (uint64_t)profondeur << 32 | (uint64_t)borne << 40 | (uint64_t)(coup + 1) << 42;
+    atomic_store_explicit(&entree->verrou, cle ^ donnees, memory_order_relaxed);
+    atomic_store_explicit(&entree->donnees, donnees, memory_order_relaxed);
+}
+
+/**
+ * @brief Recherche alpha-bêta (forme negamax) depuis un état compact.
  *
- * Cette fonction crée un plateau de jeu avec des bordures (le caractare '#')
- * et laisse les zones internes vides (le caractare ' '). Elle supprime aussi
- * les bordures centrales pour simuler des portails.
+ * Les serpents jouent à tour de rôle et chaque niveau de profondeur est un
+ * coup d'un seul serpent ; un serpent bloqué passe son tour. Le score est
+ * donné du point de vue du serpent au trait (voir evaluerAlphaBeta()).
+ *
+ * La table de transposition range les scores moins les pommes d'avance déjà
+ * acquises par le serpent au trait, pour qu'une position atteinte par des
+ * chemins différents, ou à un autre tour, y retrouve la même valeur.
  *
- * @param plateau tableau représentant le plateau de jeu.
- * @param LePavesX coordonnées X des pavés
- * @param lesPavesY coordonnées Y des pavés
+ * @param chercheur Le chercheur du fil, interrompu quand l'échéance passe.
+ * @param etat L'état compact.
+ * @param cle Clé Zobrist de l'état.
+ * @param profondeur Nombre de coups restant à développer.
+ * @param alpha Score déjà assuré au serpent au trait.
+ * @param beta Score au-delà duquel l'adversaire évite cet état.
+ * @param meilleurCoup À la racine, reçoit le meilleur coup dont la recherche est complète ; NULL ailleurs.
+ * @return Le score de l'état, sans signification si la recherche est interrompue.
  */
-void initPlateau(tPlateau plateau) {
-    int lesPavesX[NB_PAVES] = { 4, 73, 4, 73, 38, 38};
-	int lesPavesY[NB_PAVES] = { 4, 4, 33, 33, 14, 22};
+int chercherAlphaBeta(tChercheurAlphaBeta *chercheur, const tEtatMcts *etat, uint64_t cle, int profondeur, int alpha, int beta, int *meilleurCoup) {
+    tAgentAlphaBeta *agent = chercheur->agent;
+    tContexteMcts *contexte = &agent->contexte;
+    int acquis = POINTS_POMME * (etat->pommes[etat->joueur] - etat->pommes[1 - etat->joueur]);
+    int score, profondeurRangee, borne, coupPrefere = AUCUNE_DIRECTION;
+    struct timespec maintenant;
 
-    for (int i = 1; i <= LARGEUR_PLATEAU; i++) {
-        for (int j = 1; j <= HAUTEUR_PLATEAU; j++) {
-            plateau[i][j] = VIDE;
+    if (++chercheur->nbNoeuds % NOEUDS_ENTRE_HORLOGES == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &maintenant);
+        if (dureeNanosecondes(contexte->echeance, maintenant) >= 0) {
+            chercheur->interrompue = true;
         }
     }
-    for (int i = 1; i <= LARGEUR_PLATEAU; i++) {
-        plateau[i][1] = plateau[i][HAUTEUR_PLATEAU] = BORDURE;
+    if (chercheur->interrompue) {
+        return 0;
     }
-    for (int j = 1; j <= HAUTEUR_PLATEAU; j++) {
-        plateau[1][j] = plateau[LARGEUR_PLATEAU][j] = BORDURE;
+    if (profondeur == 0 || feuilleAlphaBeta(etat, contexte)) {
+        return evaluerAlphaBeta(etat, contexte);
     }
 
-    plateau[LARGEUR_PLATEAU / 2][1] = VIDE;
-    plateau[LARGEUR_PLATEAU / 2][HAUTEUR_PLATEAU] = VIDE;
-    plateau[1][HAUTEUR_PLATEAU / 2] = VIDE;
-    plateau[LARGEUR_PLATEAU][HAUTEUR_PLATEAU / 2] = VIDE;
+    if (lireTransposition(agent, cle, &score, &profondeurRangee, &borne, &coupPrefere)) {
+        score += acquis;
+        if (meilleurCoup == NULL && profondeurRangee >= profondeur
+            && (borne == BORNE_EXACTE || (borne == BORNE_INFERIEURE && score >= beta) || (borne == BORNE_SUPERIEURE && score <= alpha))) {
+            return score;
+        }
+    }
 
-    // définition des pavés
-    for (int indicePave=0; indicePave < NB_PAVES; indicePave++){
-        for (int largeur=0; largeur < TAILLE_PAVE_X; largeur++){
-            for (int hauteur=0; hauteur < TAILLE_PAVE_Y; hauteur ++){
-                plateau[lesPavesX[indicePave]+largeur][lesPavesY[indicePave]+hauteur]= PAVE;
+    int lesCoups[NB_DIRECTIONS];
+    int nbCoups = coupsMcts(etat, contexte->plateau, lesCoups);
+    if (nbCoups == 0) {
+        lesCoups[nbCoups++] = AUCUNE_DIRECTION;
+    } else {
+        ordonnerCoups(etat, contexte, lesCoups, nbCoups, coupPrefere);
+    }
+
+    int alphaInitial = alpha, scoreMax = -SCORE_INFINI, meilleur = lesCoups[0];
+    for (int i = 0; i < nbCoups; i++) {
+        tEtatMcts suivant = *etat;
+        uint64_t cleSuivante = jouerCoupAlphaBeta(&suivant, cle, lesCoups[i], contexte);
+        score = -chercherAlphaBeta(chercheur, &suivant, cleSuivante, profondeur - 1, -beta, -alpha, NULL);
+        if (chercheur->interrompue) {
+            return 0;
+        }
+        if (score > scoreMax) {
+            scoreMax = score;
+            meilleur = lesCoups[i];
+            if (meilleurCoup != NULL) {
+                *meilleurCoup = meilleur;
             }
         }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
     }
+
+    borne = (scoreMax >= beta) ? BORNE_INFERIEURE : (scoreMax <= alphaInitial) ? BORNE_SUPERIEURE : BORNE_EXACTE;
+    rangerTransposition(agent, cle, scoreMax - acquis, profondeur, borne, meilleur);
+    return scoreMax;
 }
 
 /**
- * @brief Calcule la distance optimale vers une pomme en tenant compte des portails.
+ * @brief Approfondit itérativement la recherche alpha-bêta jusqu'à l'échéance.
  *
- * Cette fonction calcule la distance la plus courte entre le serpent et une pomme,
- * en tenant compte de la possibilité d'utiliser les portails pour se téléporter.
+ * Chaque itération cherche un coup plus loin que la précédente, en essayant
+ * d'abord le meilleur coup qu'elle a laissé dans la table de transposition.
+ * Le coup retenu est celui de la dernière itération terminée ; une itération
+ * interrompue le remplace par le meilleur des coups dont elle a terminé la
+ * recherche, le premier essayé étant justement le coup retenu.
  *
- * @param serpentX La position X du serpent.
- * @param serpentY La position Y du serpent.
- * @param pommeX La position X de la pomme.
- * @param pommeY La position Y de la pomme.
- * @param nouvelleX Pointeur vers la nouvelle position X du serpent.
- * @param nouvelleY Pointeur vers la nouvelle position Y du serpent.
- * @param utilisePortail Pointeur vers une variable booléenne indiquant si un portail est à utilisé.
+ * @param donnees Le chercheur du fil (tChercheurAlphaBeta).
+ * @return NULL.
  */
-void calculerDistanceOptimale(int serpentX, int serpentY, int pommeX, int pommeY, int *nouvelleX, int *nouvelleY, bool *utilisePortail) {
-    // Coordonnées des portails
-    int portailGaucheX = 1, portailGaucheY = HAUTEUR_PLATEAU / 2;
-    int portailDroitX = LARGEUR_PLATEAU, portailDroitY = HAUTEUR_PLATEAU / 2;
-    int portailHautX = LARGEUR_PLATEAU / 2, portailHautY = 1;
-    int portailBasX = LARGEUR_PLATEAU / 2, portailBasY = HAUTEUR_PLATEAU;
-
-    // Distance directe entre le serpent et la pomme
-    int distanceDirecte = abs(pommeX - serpentX) + abs(pommeY - serpentY);
-
-    // Distances via les portails
-    int distanceViaGauche = abs(serpentX - portailGaucheX) + abs(serpentY - portailGaucheY) +
-                            abs(portailDroitX - pommeX) + abs(portailDroitY - pommeY)-1;
-    int distanceViaDroit = abs(serpentX - portailDroitX) + abs(serpentY - portailDroitY) +
-                           abs(portailGaucheX - pommeX) + abs(portailGaucheY - pommeY)+1;
-    int distanceViaHaut = abs(serpentX - portailHautX) + abs(serpentY - portailHautY) +
-                          abs(portailBasX - pommeX) + abs(portailBasY - pommeY)+1;
-    int distanceViaBas = abs(serpentX - portailBasX) + abs(serpentY - portailBasY) +
-                         abs(portailHautX - pommeX) + abs(portailHautY - pommeY)-1;
-
-    // Initialisation de la distance minimale
-    int distanceMin = distanceDirecte;
-    *nouvelleX = pommeX;
-    *nouvelleY = pommeY;
-    *utilisePortail = false;
+void *approfondirAlphaBeta(void *donnees) {
+    tChercheurAlphaBeta *chercheur = donnees;
+    tAgentAlphaBeta *agent = chercheur->agent;
 
-    // Comparaison avec les distances via les portails
-    if (distanceViaGauche < distanceMin) {
-        distanceMin = distanceViaGauche;
-        *nouvelleX = portailGaucheX-1;  // Se diriger vers le portail gauche
-        *nouvelleY = portailGaucheY;
-        *utilisePortail = true;
-    }
-    if (distanceViaDroit < distanceMin) {
-        distanceMin = distanceViaDroit;
-        *nouvelleX = portailDroitX+1;  // Se diriger vers le portail droit
-        *nouvelleY = portailDroitY;
-        *utilisePortail = true;
-    }
-    if (distanceViaHaut < distanceMin) {
-        distanceMin = distanceViaHaut;
-        *nouvelleX = portailHautX;  // Se diriger vers le portail haut
-        *nouvelleY = portailHautY+1;
-        *utilisePortail = true;
-    }
-    if (distanceViaBas < distanceMin) {
-        distanceMin = distanceViaBas;
-        *nouvelleX = portailBasX;  // Se diriger vers le portail bas
-        *nouvelleY = portailBasY-1;
-        *utilisePortail = true;
+    chercheur->nbNoeuds = 0;
+    chercheur->interrompue = false;
+    for (int profondeur = chercheur->premiereProfondeur; profondeur <= PROFONDEUR_MAX_ALPHABETA; profondeur++) {
+        int coup = AUCUNE_DIRECTION;
+        chercherAlphaBeta(chercheur, &agent->contexte.racine, agent->cleRacine, profondeur, -SCORE_INFINI, SCORE_INFINI, &coup);
+        if (coup != AUCUNE_DIRECTION) {
+            chercheur->meilleurCoup = coup;
+        }
+        if (chercheur->interrompue) {
+            break;
+        }
     }
+    return NULL;
 }
 
+/**
+ * @brief Choisit le coup du premier serpent par recherche alpha-bêta.
+ *
+ * La partie est résumée dans le même état compact que pour l'agent MCTS
+ * (voir tEtatMcts), repéré par sa clé Zobrist. La recherche s'approfondit
+ * itérativement (voir approfondirAlphaBeta()) et rend le meilleur coup trouvé
+ * quand budgetAlphaBeta millisecondes sont écoulées ; l'horloge étant lue
+ * tous les NOEUDS_ENTRE_HORLOGES nœuds, l'échéance n'est dépassée que de
+ * quelques microsecondes. À budget égal, le coup ne dépend que de la
+ * vitesse de la machine, pas du hasard.
+ *
+ * Comme l'agent MCTS, il joue contre le second serpent et n'accepte pas
+ * l'option --cooperatif.
+ *
+ * Avec plusieurs fils d'exécution, les fils auxiliaires cherchent la même
+ * racine en décalé et partagent la table de transposition ; le coup joué
+ * reste celui du fil du jeu.
+ *
+ * @param agent L'agent alpha-bêta.
+ * @param lesSerpents Les deux serpents de la partie, le premier au trait.
+ * @param indexPomme Indice de la pomme présente.
+ * @param plateau Le plateau de jeu.
+ * @param itineraire Champs de distances de la pomme présente et des suivantes.
+ * @param lesPommesX Positions X des pommes.
+ * @param lesPommesY Positions Y des pommes.
+ * @return La direction choisie, AUCUNE_DIRECTION si le serpent est bloqué.
+ */
+int deciderAlphaBeta(tAgentAlphaBeta *agent, tSerpent lesSerpents[], int indexPomme, tPlateau *plateau, tItineraire *itineraire, int lesPommesX[], int lesPommesY[]) {
+    tContexteMcts *contexte = &agent->contexte;
+    int lesCoups[NB_DIRECTIONS];
 
-// Fonction pour vérifier les collisions avec le corps du serpent
-bool collision(int x, int y, int lesX[], int lesY[], int lesX_2[], int lesY_2[]) {
-    bool res = false;
-    for (int i = 1; i < TAILLE; i++) {
-        if (lesX[i] == x && lesY[i] == y) {
-            res = true; // Il y a une collision
-            break; // Sort de la boucle das qu'une collision est détectée
-        }
-    }
-    for (int i = 0; i < TAILLE; i++) {
-        if (lesX_2[i] == x && lesY_2[i] == y) {
-            res = true; // Il y a une collision
-            break; // Sort de la boucle si une collision est détectée
-        }
-    }
-    return res;
-}
-
-/**
- * @brief Déplace le serpent vers la cible (pomme ou portail).
- *
- * Cette fonction déplace la tête du serpent en fonction de la cible (pomme ou portail)
- * et déplace ensuite le corps en suivant la tête.
- *
- * @param lesX Tableau des positions X des segments du serpent.
- * @param lesY Tableau des positions Y des segments du serpent.
- * @param cibleX Position X de la cible (pomme ou portail).
- * @param cibleY Position Y de la cible (pomme ou portail).
- * @param plateau Le plateau de jeu.
- * @param pomme Pointeur vers une variable booléenne indiquant si la pomme est mangée.
- */
-void progresser1(int lesX[], int lesY[], int lesX_2[], int lesY_2[], int cibleX, int cibleY, tPlateau plateau, bool *pomme) {
-    int prochainX = cibleX, prochainY = cibleY;
-    bool utilisePortail = false;
-    // Déterminer la cible optimale (directe ou via un portail)
-    calculerDistanceOptimale(lesX[0], lesY[0], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
-
-    // Efface le dernier segment du serpent
-    effacer(lesX[TAILLE - 1], lesY[TAILLE - 1]);
-
-    // Déplace les segments du corps
-    for (int i = TAILLE - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
-    }
-    // si un portail est à utiliser utilisePortail=true
-    if (utilisePortail) {
-        // se déplace en choisissant le chemin optimal à utiliser ici il est plus optimiser d'aller vers le haut cela réduit le nombre de déplacement
-        bool endroitBloque=true;
-        if (lesY[0] < prochainY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2)) {
-            lesY[0]++;
-            endroitBloque=false;
-        } else if (lesY[0] > prochainY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2)) {
-            lesY[0]--;
-            endroitBloque=false;
-        } else if (lesX[0] < prochainX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-            lesX[0]++;
-            endroitBloque=false ;
-        } else if (lesX[0] > prochainX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-            lesX[0]--;
-            endroitBloque=false;
-        }
-        //si le chemin optimal est bloqué par les bord, le corp du serpent et la position du serpent par rapport à la cible 
-        //on recherche le chemin optimal pour sortir le plus facilement avec les contraintes des bordures et du corps du serpent
-        if (endroitBloque){
-            if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                lesX[0]++;
-            } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                lesX[0]--;
-            } else if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2)) {
-                lesY[0]++;
-            } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2)) {
-                lesY[0]--;
-            }
-        }
-        // Vérifier si le serpent a atteint le portail
-        if (lesX[0] == prochainX && lesY[0] == prochainY) {
-            // Recalculer la cible après avoir traversé le portail 
-            // les valeurs d'arrivé sont 2 et LARGEUR_PLATEAU-1 puisque le serpent ne doit pas sortir du plateau
-            if (prochainY == HAUTEUR_PLATEAU+1) {
-                lesY[0] = 1;
-            } else if (prochainY == 0) {
-                lesY[0] = HAUTEUR_PLATEAU;
-            } else if (prochainX == LARGEUR_PLATEAU+1) {
-                lesX[0] = 1;
-            } else if (prochainX == 0) {
-                lesX[0] = LARGEUR_PLATEAU;
-            } 
-            //On redéfini où doit passer le serpent
-            calculerDistanceOptimale(lesX[0], lesY[0], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
-        }
-    } else {
-        // Déplacement optimal vers la cible en évitant les collisions avec le corps du serpent et les bordures
-        if (lesY[0] < cibleY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]-1][lesY[0]+1]==PAVE && plateau[lesX[0]+1][lesY[0]+1]==PAVE)) || cibleX>lesX[0]-TAILLE_PAVE_X)) {
-            lesY[0]++;
-        } else if (lesY[0] > cibleY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]-1][lesY[0]-1]==PAVE && plateau[lesX[0]+1][lesY[0]-1]==PAVE)) || cibleX<lesX[0]+TAILLE_PAVE_X)) {
-            lesY[0]--;
-        } else if (lesX[0] < cibleX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]+1][lesY[0]+1]==PAVE && plateau[lesX[0]+1][lesY[0]-1]==PAVE)) || cibleY<lesY[0]+TAILLE_PAVE_Y)) {
-            lesX[0]++;
-        } else if (lesX[0] > cibleX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]-1][lesY[0]-1]==PAVE && plateau[lesX[0]-1][lesY[0]+1]==PAVE)) || cibleY<lesY[0]+TAILLE_PAVE_Y)) {
-            lesX[0]--;
-        } else {
-            // Déplacement optimal vers la cible en évitant les collisions avec le corps, les bordures et les pavés
-            if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && cibleY>lesY[0] && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] < TAILLE - 1) {
-                lesY[0]++;
-            } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && cibleY<lesY[0] && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] > 0) {
-                lesY[0]--;
-            } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && cibleX<lesX[0] && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] < TAILLE - 1) {
-                lesX[0]++;
-            } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && cibleX>lesX[0] && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] > 0) {
-                lesX[0]--;
-            } else {
-                //Déplacement vers la cible en évitant les collisions le corps, les bordures et les pavés
-                if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] < TAILLE-1) {
-                    lesY[0]++;
-                } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] > 0) {
-                    lesY[0]--;
-                } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] < TAILLE-1) {
-                    lesX[0]++;
-                } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] > 0) {
-                    lesX[0]--;
-                } else {
-                    // Si aucune direction n'était possible, se déplace aléatoirement en évitant le corps et les bordures
-                    if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2)) {
-                        lesY[0]++;
-                    } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2)) {
-                        lesY[0]--;
-                    } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                        lesX[0]++;
-                    } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                        lesX[0]--;
-                    }
-                }
-            }
-        }
+    lireEtatMcts(&contexte->racine, lesSerpents, indexPomme);
+    contexte->plateau = plateau;
+    contexte->itineraire = itineraire;
+    contexte->lesPommesX = lesPommesX;
+    contexte->lesPommesY = lesPommesY;
+    int nbCoups = coupsMcts(&contexte->racine, plateau, lesCoups);
+    if (nbCoups <= 1) {
+        return (nbCoups == 1) ? lesCoups[0] : AUCUNE_DIRECTION;
     }
-    if (lesX[0]<1){
-        lesX[0]=LARGEUR_PLATEAU;
-        utilisePortail=false;
-    } 
-    if (lesX[0]>LARGEUR_PLATEAU){
-        lesX[0]=1;
-        utilisePortail=false;
-    } 
-    if (lesY[0]<1){
-        lesY[0]=HAUTEUR_PLATEAU;
-        utilisePortail=false;
-    }
-    if (lesY[0]>HAUTEUR_PLATEAU){
-        lesY[0]=1;
-        utilisePortail=false;
-    }
-    // Vérifie si la tête du serpent atteint la pomme
-    *pomme = (lesX[0] == cibleX && lesY[0] == cibleY);
-
-    // Redessine le serpent
-    dessinerSerpent(lesX, lesY);
-}
-
-void progresser2(int lesX[], int lesY[], int lesX_2[], int lesY_2[], int cibleX, int cibleY, tPlateau plateau, bool *pomme) {
-    int prochainX = cibleX, prochainY = cibleY;
-    bool utilisePortail = false;
-
-    // Déterminer la cible optimale (directe ou via un portail)
-    calculerDistanceOptimale(lesX[0], lesY[0], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
-
-    // Efface le dernier segment du serpent
-    effacer(lesX[TAILLE - 1], lesY[TAILLE - 1]);
-
-    // Déplace les segments du corps
-    for (int i = TAILLE - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
-    }
-    // si un portail est à utiliser utilisePortail=true
-    if (utilisePortail) {
-        // se déplace en choisissant le chemin optimal à utiliser ici il est plus optimiser d'aller vers le haut cela réduit le nombre de déplacement
-        bool endroitBloque=true;
-        if (lesY[0] < prochainY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2)) {
-            lesY[0]++;
-            endroitBloque=false;
-        } else if (lesY[0] > prochainY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2)) {
-            lesY[0]--;
-            endroitBloque=false;
-        } else if (lesX[0] < prochainX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-            lesX[0]++;
-            endroitBloque=false ;
-        } else if (lesX[0] > prochainX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-            lesX[0]--;
-            endroitBloque=false;
-        }
-        //si le chemin optimal est bloqué par les bord, le corp du serpent et la position du serpent par rapport à la cible 
-        //on recherche le chemin optimal pour sortir le plus facilement avec les contraintes des bordures et du corps du serpent
-        if (endroitBloque){
-            if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                lesX[0]++;
-            } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                lesX[0]--;
-            } else if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2)) {
-                lesY[0]++;
-            } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2)) {
-                lesY[0]--;
-            }
-        }
-        // Vérifier si le serpent a atteint le portail
-        if (lesX[0] == prochainX && lesY[0] == prochainY) {
-            // Recalculer la cible après avoir traversé le portail 
-            // les valeurs d'arrivé sont 2 et LARGEUR_PLATEAU-1 puisque le serpent ne doit pas sortir du plateau
-            if (prochainY == HAUTEUR_PLATEAU+1) {
-                lesY[0] = 1;
-            } else if (prochainY == 0) {
-                lesY[0] = HAUTEUR_PLATEAU;
-            } else if (prochainX == LARGEUR_PLATEAU+1) {
-                lesX[0] = 1;
-            } else if (prochainX == 0) {
-                lesX[0] = LARGEUR_PLATEAU;
-            } 
-            //On redéfini où doit passer le serpent
-            calculerDistanceOptimale(lesX[0], lesY[0], cibleX, cibleY, &prochainX, &prochainY, &utilisePortail);
-        }
-    } else {
-        // Déplacement optimal vers la cible en évitant les collisions avec le corps du serpent et les bordures
-        if (lesY[0] < cibleY && plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]-1][lesY[0]+1]==PAVE && plateau[lesX[0]+1][lesY[0]+1]==PAVE)) || cibleX>lesX[0]-TAILLE_PAVE_X)) {
-            lesY[0]++;
-        } else if (lesY[0] > cibleY && plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]-1][lesY[0]-1]==PAVE && plateau[lesX[0]+1][lesY[0]-1]==PAVE)) || cibleX<lesX[0]+TAILLE_PAVE_X)) {
-            lesY[0]--;
-        } else if (lesX[0] < cibleX && plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]+1][lesY[0]+1]==PAVE && plateau[lesX[0]+1][lesY[0]-1]==PAVE)) || cibleY<lesY[0]+TAILLE_PAVE_Y)) {
-            lesX[0]++;
-        } else if (lesX[0] > cibleX && plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && ((!(plateau[lesX[0]-1][lesY[0]-1]==PAVE && plateau[lesX[0]-1][lesY[0]+1]==PAVE)) || cibleY<lesY[0]+TAILLE_PAVE_Y)) {
-            lesX[0]--;
-        } else {
-            // Déplacement optimal vers la cible en évitant les collisions avec le corps, les bordures et les pavés
-            if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && cibleY>lesY[0] && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] < TAILLE - 1) {
-                lesY[0]++;
-            } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && cibleY<lesY[0] && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] > 0) {
-                lesY[0]--;
-            } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && cibleX<lesX[0] && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] < TAILLE - 1) {
-                lesX[0]++;
-            } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && cibleX>lesX[0] && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] > 0) {
-                lesX[0]--;
-            } else {
-                //Déplacement vers la cible en évitant les collisions le corps, les bordures et les pavés
-                if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] < TAILLE-1) {
-                    lesY[0]++;
-                } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2) && lesY[0] > 0) {
-                    lesY[0]--;
-                } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] < TAILLE-1) {
-                    lesX[0]++;
-                } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2) && lesX[0] > 0) {
-                    lesX[0]--;
-                } else {
-                    // Si aucune direction n'était possible, se déplace aléatoirement en évitant le corps et les bordures
-                    if (plateau[lesX[0]][lesY[0] + 1] != BORDURE && !collision(lesX[0], lesY[0] + 1, lesX, lesY, lesX_2, lesY_2)) {
-                        lesY[0]++;
-                    } else if (plateau[lesX[0]][lesY[0] - 1] != BORDURE && !collision(lesX[0], lesY[0] - 1, lesX, lesY, lesX_2, lesY_2)) {
-                        lesY[0]--;
-                    } else if (plateau[lesX[0] + 1][lesY[0]] != BORDURE && !collision(lesX[0] + 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                        lesX[0]++;
-                    } else if (plateau[lesX[0] - 1][lesY[0]] != BORDURE && !collision(lesX[0] - 1, lesY[0], lesX, lesY, lesX_2, lesY_2)) {
-                        lesX[0]--;
-                    }
-                }
-            }
+    agent->cleRacine = clePosition(&contexte->racine);
+
+    clock_gettime(CLOCK_MONOTONIC, &contexte->echeance);
+    contexte->echeance.tv_nsec += (long)budgetAlphaBeta * 1000000L;
+    contexte->echeance.tv_sec += contexte->echeance.tv_nsec / 1000000000L;
+    contexte->echeance.tv_nsec %= 1000000000L;
+
+    // Sans itération complète, le coup le plus proche de la pomme
+    ordonnerCoups(&contexte->racine, contexte, lesCoups, nbCoups, AUCUNE_DIRECTION);
+    agent->lesChercheurs[0].meilleurCoup = lesCoups[0];
+    for (int i = 1; i < agent->nbChercheurs; i++) {
+        int erreur = pthread_create(&agent->lesChercheurs[i].fil, NULL, approfondirAlphaBeta, &agent->lesChercheurs[i]);
+        if (erreur != 0) {
+            errno = erreur;
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
         }
     }
-    if (lesX[0]<1){
-        lesX[0]=LARGEUR_PLATEAU;
-        utilisePortail=false;
-    } 
-    if (lesX[0]>LARGEUR_PLATEAU){
-        lesX[0]=1;
-        utilisePortail=false;
-    } 
-    if (lesY[0]<1){
-        lesY[0]=HAUTEUR_PLATEAU;
-        utilisePortail=false;
-    }
-    if (lesY[0]>HAUTEUR_PLATEAU){
-        lesY[0]=1;
-        utilisePortail=false;
+    approfondirAlphaBeta(&agent->lesChercheurs[0]);
+    for (int i = 1; i < agent->nbChercheurs; i++) {
+        pthread_join(agent->lesChercheurs[i].fil, NULL);
     }
-    // Vérifie si la tête du serpent atteint la pomme
-    *pomme = (lesX[0] == cibleX && lesY[0] == cibleY);
-
-    // Redessine le serpent
-    dessinerSerpent(lesX, lesY);
+    return agent->lesChercheurs[0].meilleurCoup;
 }
 
 /**
  * @brief Affiche le plateau.
  *
- * Cette fonction affiche le plateau complet sur la console.
+ * Cette fonction affiche le plateau sur la console, limité à la zone
+ * affichée pour les plateaux plus grands que l'écran.
  *
  * @param plateau Le plateau de jeu.
  */
-void dessinerPlateau(tPlateau plateau) {
-    for (int i = 1; i <= LARGEUR_PLATEAU; i++) {
-        for (int j = 1; j <= HAUTEUR_PLATEAU; j++) {
-            afficher(i, j, plateau[i][j]);
+void dessinerPlateau(tPlateau *plateau) {
+    if (modeSansAffichage) {
+        return;
+    }
+    for (int j = 1; j <= hauteurPlateau && j <= HAUTEUR_ECRAN; j++) {
+        for (int i = 1; i <= largeurPlateau && i <= LARGEUR_ECRAN; i++) {
+            afficher(i, j, lireCase(&plateau->rendu, i, j));
         }
     }
 }
@@ -547,16 +4426,56 @@ void dessinerPlateau(tPlateau plateau) {
 /**
  * @brief Affiche un caractare à  une position donnée.
  *
- * Cette fonction affiche un caractare à  la position spécifiée dans la console.
+ * Cette fonction écrit le caractare dans le tampon arrière. Il ne sera envoyé
+ * au terminal qu'au prochain appel de rafraichirEcran().
  *
  * @param x Position X de l'affichage.
  * @param y Position Y de l'affichage.
  * @param car Caractare à  afficher.
  */
 void afficher(int x, int y, char car) {
-    gotoxy(x, y);
-    printf("%c", car);
-    fflush(stdout);
+    if (modeSansAffichage) {
+        return;
+    }
+    if (x >= 1 && x <= LARGEUR_ECRAN && y >= 1 && y <= HAUTEUR_ECRAN) {
+        ecranCourant[y][x] = car;
+    }
+}
+
+/**
+ * @brief Envoie au terminal les cases modifiées depuis le dernier rafraîchissement.
+ *
+ * Cette fonction compare le tampon arrière au tampon avant et construit une
+ * seule trame contenant uniquement les cases qui ont changé. Le positionnement
+ * du curseur est omis pour les cases consécutives d'une même ligne.
+ * La trame est envoyée en un seul appel à write().
+ */
+void rafraichirEcran() {
+    if (modeSansAffichage) {
+        return;
+    }
+
+    static char tampon[TAILLE_TAMPON_ECRAN];
+    int longueur = 0;
+
+    for (int y = 1; y <= HAUTEUR_ECRAN; y++) {
+        int dernierX = -1;
+        for (int x = 1; x <= LARGEUR_ECRAN; x++) {
+            if (ecranCourant[y][x] != ecranAffiche[y][x]) {
+                if (dernierX != x - 1) {
+                    longueur += sprintf(tampon + longueur, "\033[%d;%dH", y, x);
+                }
+                tampon[longueur++] = ecranCourant[y][x];
+                ecranAffiche[y][x] = ecranCourant[y][x];
+                dernierX = x;
+            }
+        }
+    }
+
+    if (longueur > 0) {
+        fflush(stdout);
+        write(STDOUT_FILENO, tampon, longueur);
+    }
 }
 
 /**
@@ -577,14 +4496,13 @@ void effacer(int x, int y) {
  * Cette fonction dessine le serpent sur le plateau en affichant la tête
  * et les segments du corps.
  *
- * @param lesX Tableau des positions X des segments du serpent.
- * @param lesY Tableau des positions Y des segments du serpent.
+ * @param serpent Le serpent à dessiner.
  */
-void dessinerSerpent(int lesX[], int lesY[]) {
-    afficher(lesX[0], lesY[0], TETE);
-    for (int i = 1; i < TAILLE; i++) {
-        afficher(lesX[i], lesY[i], CORPS);
+void dessinerSerpent(tSerpent *serpent) {
+    for (int i = serpent->taille - 1; i >= 1; i--) {
+        afficher(ANNEAU(serpent, i).x, ANNEAU(serpent, i).y, CORPS);
     }
+    afficher(ANNEAU(serpent, 0).x, ANNEAU(serpent, 0).y, TETE);
 }
 
 /**
@@ -618,28 +4536,465 @@ void finProgramme(int nbDeplacements, clock_t tempsDebut, clock_t tempsFin) {
 }
 
 /**
- * @brief Vérifie si une touche a été appuyée.
+ * @brief Enchaîne des parties sans affichage et affiche leurs statistiques.
+ *
+ * La partie i utilise la graine graine + i. Avec la disposition fixe, toutes
+ * les parties reprennent les pommes prévues et ne mesurent que la vitesse du
+ * moteur ; avec la disposition aléatoire, les pavés puis les pommes sont tirés
+ * à partir de la graine de la partie. Le bilan (déplacements, pommes mangées, tours par seconde et
+ * percentiles de la durée de décision d'un tour) est affiché en clair et,
+ * si fichierCsv est donné, ajouté à ce fichier à raison d'une ligne par
+ * partie et d'une ligne de total.
+ *
+ * @param nbParties Nombre de parties à jouer.
+ * @param graine Graine de la première partie.
+ * @param aleatoire Vrai pour tirer les pavés et les pommes au hasard.
+ * @param lesPavesX Positions X des pavés prévus.
+ * @param lesPavesY Positions Y des pavés prévus.
+ * @param lesPommesX Positions X des pommes prévues.
+ * @param lesPommesY Positions Y des pommes prévues.
+ * @param fichierCsv Fichier CSV à compléter, ou NULL.
+ */
+void lancerBenchmark(int nbParties, unsigned int graine, bool aleatoire, int lesPavesX[], int lesPavesY[], int lesPommesX[], int lesPommesY[], const char *fichierCsv) {
+    tLatences latences = {NULL, 0, 0};
+    int partiePavesX[NB_PAVES], partiePavesY[NB_PAVES];
+    int partiePommesX[NB_POMMES], partiePommesY[NB_POMMES];
+    long totalDeplacements = 0, totalPommes = 0, totalPommesPremier = 0;
+    int nbAbandons = 0;
+    long p50, p99, max;
+    FILE *csv = NULL;
+    struct timespec debut, fin, debutPartie, finPartie;
+
+    modeSansAffichage = true;
+
+    if (fichierCsv != NULL) {
+        csv = fopen(fichierCsv, "a");
+        if (csv == NULL) {
+            perror(fichierCsv);
+            exit(EXIT_FAILURE);
+        }
+        // L'entête n'est écrite que dans un fichier neuf, pour cumuler plusieurs variantes
+        if (ftell(csv) == 0) {
+            fprintf(csv, "variante,partie,graine,disposition,deplacements,pommes,abandon,tours_par_seconde,latence_p50_ns,latence_p99_ns,latence_max_ns\n");
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nbParties; i++) {
+        if (aleatoire) {
+            genererPaves(graine + i, partiePavesX, partiePavesY);
+            genererPommes(graine + i, partiePavesX, partiePavesY, partiePommesX, partiePommesY);
+        } else {
+            memcpy(partiePavesX, lesPavesX, sizeof(partiePavesX));
+            memcpy(partiePavesY, lesPavesY, sizeof(partiePavesY));
+            memcpy(partiePommesX, lesPommesX, sizeof(partiePommesX));
+            memcpy(partiePommesY, lesPommesY, sizeof(partiePommesY));
+        }
+
+        int premiereDuree = latences.nbDurees;
+        clock_gettime(CLOCK_MONOTONIC, &debutPartie);
+        tPartie partie = jouerPartie(partiePavesX, partiePavesY, partiePommesX, partiePommesY, MAX_DEPLACEMENTS, &latences);
+        clock_gettime(CLOCK_MONOTONIC, &finPartie);
+
+        totalDeplacements += partie.nbDeplacements;
+        totalPommes += partie.nbPommesMangees;
+        totalPommesPremier += partie.nbPommesPremier;
+        if (partie.abandonnee) {
+            nbAbandons++;
+        }
+
+        if (csv != NULL) {
+            // Les durées de la partie sont triées sur place : le tri global final n'en dépend pas
+            calculerPercentiles(latences.lesDurees + premiereDuree, latences.nbDurees - premiereDuree, &p50, &p99, &max);
+            double secondes = dureeNanosecondes(debutPartie, finPartie) / 1e9;
+            fprintf(csv, "%s,%d,%u,%s,%d,%d,%d,%.0f,%ld,%ld,%ld\n", NOM_VARIANTE, i, graine + i,
+                    aleatoire ? "aleatoire" : "fixe", partie.nbDeplacements, partie.nbPommesMangees,
+                    partie.abandonnee ? 1 : 0, secondes > 0 ? partie.nbDeplacements / secondes : 0.0, p50, p99, max);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    double secondes = dureeNanosecondes(debut, fin) / 1e9;
+    double toursParSeconde = secondes > 0 ? totalDeplacements / secondes : 0.0;
+    calculerPercentiles(latences.lesDurees, latences.nbDurees, &p50, &p99, &max);
+
+    printf("Benchmark %s : %d parties, graine %u, disposition %s\n", NOM_VARIANTE, nbParties, graine,
+           aleatoire ? "aleatoire" : "fixe");
+    printf("Nombre de déplacements : %ld\n", totalDeplacements);
+    printf("Pommes mangées : %ld / %ld\n", totalPommes, (long)nbParties * NB_POMMES);
+    if (nbSerpents > 1) {
+        printf("Pommes du premier serpent%s : %ld / %ld\n", modeMcts ? " (agent MCTS)" : modeAlphaBeta ? " (agent alpha-bêta)" : "",
+               totalPommesPremier, totalPommes);
+    }
+    printf("Parties abandonnées : %d\n", nbAbandons);
+    printf("Tours par seconde : %.0f\n", toursParSeconde);
+    printf("Latence de décision (ns) : p50 %ld, p99 %ld, max %ld\n", p50, p99, max);
+
+    if (csv != NULL) {
+        fprintf(csv, "%s,total,%u,%s,%ld,%ld,%d,%.0f,%ld,%ld,%ld\n", NOM_VARIANTE, graine,
+                aleatoire ? "aleatoire" : "fixe", totalDeplacements, totalPommes, nbAbandons,
+                toursParSeconde, p50, p99, max);
+        fclose(csv);
+    }
+    free(latences.lesDurees);
+}
+
+/**
+ * @brief Initialise un générateur pseudo-aléatoire à partir d'une graine.
+ *
+ * Les quatre mots d'état sont tirés de la graine par splitmix64, qui ne donne
+ * jamais un état entièrement nul.
+ *
+ * @param aleatoire Générateur à initialiser.
+ * @param graine Graine du tirage.
+ */
+void initialiserAleatoire(tAleatoire *aleatoire, uint64_t graine) {
+    for (int i = 0; i < 4; i++) {
+        graine += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = graine;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        aleatoire->etat[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * @brief Tire le nombre pseudo-aléatoire suivant (xoshiro256**).
+ *
+ * @param aleatoire Le générateur.
+ * @return Un entier de 64 bits.
+ */
+uint64_t tirerAleatoire(tAleatoire *aleatoire) {
+    uint64_t *etat = aleatoire->etat;
+    uint64_t resultat = etat[1] * 5;
+    resultat = ((resultat << 7) | (resultat >> 57)) * 9;
+    uint64_t decale = etat[1] << 17;
+
+    etat[2] ^= etat[0];
+    etat[3] ^= etat[1];
+    etat[1] ^= etat[2];
+    etat[0] ^= etat[3];
+    etat[2] ^= decale;
+    etat[3] = (etat[3] << 45) | (etat[3] >> 19);
+    return resultat;
+}
+
+/**
+ * @brief Tire un entier uniformément entre 0 et borne - 1.
+ *
+ * Les tirages qui tomberaient dans le reste de la division de 2^64 par borne
+ * sont rejetés, pour que toutes les valeurs soient équiprobables.
+ *
+ * @param aleatoire Le générateur.
+ * @param borne Nombre de valeurs possibles (strictement positif).
+ * @return Un entier de 0 à borne - 1.
+ */
+int tirerEntier(tAleatoire *aleatoire, int borne) {
+    uint64_t limite = UINT64_MAX - UINT64_MAX % (uint64_t)borne;
+    uint64_t tirage;
+    do {
+        tirage = tirerAleatoire(aleatoire);
+    } while (tirage >= limite);
+    return (int)(tirage % (uint64_t)borne);
+}
+
+/**
+ * @brief Calcule la graine d'un flux du générateur pour une partie.
+ *
+ * Les pavés et les pommes d'une même partie sont tirés dans des flux
+ * distincts : changer le tirage des uns ne décale pas celui des autres.
+ *
+ * @param graine Graine de la partie.
+ * @param flux FLUX_POMMES ou FLUX_PAVES.
+ * @return La graine du générateur de ce flux.
+ */
+uint64_t graineFlux(unsigned int graine, int flux) {
+    return ((uint64_t)flux << 32) | graine;
+}
+
+/**
+ * @brief Calcule les distances de toutes les cases à la tête du premier serpent.
+ *
+ * Une case d'où cette position est inaccessible est enfermée par les pavés :
+ * ni un serpent ni une pomme ne doivent s'y trouver.
+ *
+ * @param plateau Le plateau de jeu.
+ * @return Le champ de distances, à libérer par l'appelant.
+ */
+short *distancesDepuisDepart(tPlateau *plateau) {
+    tParcours parcours = {0};
+    short *distances = malloc(NB_INDICES_CASES * sizeof(short));
+    if (distances == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    calculerDistances(POSITION_DEP_X_1, POSITION_DEP_Y_1, plateau, &parcours, distances);
+    detruireParcours(&parcours);
+    return distances;
+}
+
+/**
+ * @brief Tire au hasard les pavés d'une partie.
+ *
+ * Chaque pavé reste à une case des bordures, si bien que le couloir qui longe
+ * les bordures et les portails reste ouvert, et ne recouvre pas les deux
+ * serpents d'origine. Une disposition qui enferme des cases vides (pavés
+ * accolés en enclos) est entièrement retirée. Le tirage ne dépend que de la
+ * graine.
+ *
+ * @param graine Graine de la partie.
+ * @param lesPavesX Positions X des coins haut gauche des pavés tirés.
+ * @param lesPavesY Positions Y des coins haut gauche des pavés tirés.
+ */
+void genererPaves(unsigned int graine, int lesPavesX[], int lesPavesY[]) {
+    tAleatoire aleatoire;
+    bool accessible;
+    int lesDepartsY[2] = {POSITION_DEP_Y_1, POSITION_DEP_Y_2};
+
+    initialiserAleatoire(&aleatoire, graineFlux(graine, FLUX_PAVES));
+    do {
+        for (int i = 0; i < NB_PAVES; i++) {
+            bool surSerpent;
+            do {
+                lesPavesX[i] = 3 + tirerEntier(&aleatoire, largeurPlateau - TAILLE_PAVE_X - 4);
+                lesPavesY[i] = 3 + tirerEntier(&aleatoire, hauteurPlateau - TAILLE_PAVE_Y - 4);
+                surSerpent = false;
+                for (int s = 0; s < 2; s++) {
+                    surSerpent = surSerpent
+                        || (lesPavesX[i] <= POSITION_DEP_X_1 && lesPavesX[i] + TAILLE_PAVE_X > POSITION_DEP_X_1 - TAILLE + 1
+                            && lesPavesY[i] <= lesDepartsY[s] && lesPavesY[i] + TAILLE_PAVE_Y > lesDepartsY[s]);
+                }
+            } while (surSerpent);
+        }
+
+        tPlateau plateau;
+        initPlateau(&plateau, lesPavesX, lesPavesY);
+        short *distances = distancesDepuisDepart(&plateau);
+        accessible = true;
+        for (int y = 2; y < hauteurPlateau && accessible; y++) {
+            for (int x = 2; x < largeurPlateau && accessible; x++) {
+                accessible = caseObstacle(x, y, &plateau) || distances[INDICE_CASE(x, y)] != DISTANCE_INCONNUE;
+            }
+        }
+        free(distances);
+        detruireCouche(&plateau.bordures);
+        detruireCouche(&plateau.paves);
+        detruireGrille(&plateau.rendu);
+    } while (!accessible);
+}
+
+/**
+ * @brief Tire au hasard les pommes d'une partie.
+ *
+ * Chaque pomme est placée sur une case vide à l'intérieur des bordures,
+ * accessible depuis le départ des serpents, et diffère de la précédente. Le
+ * tirage ne dépend que de la graine (voir tAleatoire), ce qui permet de
+ * rejouer exactement la même partie.
+ *
+ * @param graine Graine de la partie.
+ * @param lesPavesX Positions X des pavés du plateau.
+ * @param lesPavesY Positions Y des pavés du plateau.
+ * @param lesPommesX Positions X des pommes tirées.
+ * @param lesPommesY Positions Y des pommes tirées.
+ */
+void genererPommes(unsigned int graine, int lesPavesX[], int lesPavesY[], int lesPommesX[], int lesPommesY[]) {
+    tPlateau plateau;
+    tAleatoire aleatoire;
+    initPlateau(&plateau, lesPavesX, lesPavesY);
+    initialiserAleatoire(&aleatoire, graineFlux(graine, FLUX_POMMES));
+    short *distances = distancesDepuisDepart(&plateau);
+
+    for (int i = 0; i < NB_POMMES; i++) {
+        int x, y;
+        do {
+            x = 2 + tirerEntier(&aleatoire, largeurPlateau - 2);
+            y = 2 + tirerEntier(&aleatoire, hauteurPlateau - 2);
+        } while (distances[INDICE_CASE(x, y)] == DISTANCE_INCONNUE || (i > 0 && x == lesPommesX[i - 1] && y == lesPommesY[i - 1]));
+        lesPommesX[i] = x;
+        lesPommesY[i] = y;
+    }
+    free(distances);
+    detruireCouche(&plateau.bordures);
+    detruireCouche(&plateau.paves);
+    detruireGrille(&plateau.rendu);
+}
+
+
+/**
+ * @brief Ajoute la durée de décision d'un tour aux latences relevées.
+ *
+ * @param latences Latences relevées.
+ * @param duree Durée du tour en nanosecondes.
+ */
+void enregistrerLatence(tLatences *latences, long duree) {
+    if (latences->nbDurees == latences->capacite) {
+        int capacite = latences->capacite == 0 ? MAX_DEPLACEMENTS : 2 * latences->capacite;
+        long *lesDurees = realloc(latences->lesDurees, capacite * sizeof(long));
+        if (lesDurees == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        latences->lesDurees = lesDurees;
+        latences->capacite = capacite;
+    }
+    latences->lesDurees[latences->nbDurees++] = duree;
+}
+
+/**
+ * @brief Calcule la durée écoulée entre deux instants.
+ *
+ * @param debut Instant de début.
+ * @param fin Instant de fin.
+ * @return La durée en nanosecondes.
+ */
+long dureeNanosecondes(struct timespec debut, struct timespec fin) {
+    return (fin.tv_sec - debut.tv_sec) * 1000000000L + (fin.tv_nsec - debut.tv_nsec);
+}
+
+/**
+ * @brief Compare deux durées pour qsort().
+ *
+ * @param a Pointeur vers la première durée.
+ * @param b Pointeur vers la seconde durée.
+ * @return Un entier négatif, nul ou positif selon que a est plus court, égal ou plus long que b.
+ */
+int comparerDurees(const void *a, const void *b) {
+    long dureeA = *(const long *)a, dureeB = *(const long *)b;
+    return (dureeA > dureeB) - (dureeA < dureeB);
+}
+
+/**
+ * @brief Calcule la médiane, le 99e percentile et le maximum de durées.
+ *
+ * Les durées sont triées sur place.
+ *
+ * @param lesDurees Durées en nanosecondes.
+ * @param nbDurees Nombre de durées.
+ * @param p50 Médiane des durées.
+ * @param p99 99e percentile des durées.
+ * @param max Durée la plus longue.
+ */
+void calculerPercentiles(long lesDurees[], int nbDurees, long *p50, long *p99, long *max) {
+    *p50 = *p99 = *max = 0;
+    if (nbDurees == 0) {
+        return;
+    }
+    qsort(lesDurees, nbDurees, sizeof(long), comparerDurees);
+    *p50 = lesDurees[(long)(nbDurees - 1) * 50 / 100];
+    *p99 = lesDurees[(long)(nbDurees - 1) * 99 / 100];
+    *max = lesDurees[nbDurees - 1];
+}
+
+/**
+ * @brief Passe le terminal en mode brut pour toute la partie.
+ *
+ * Les touches sont lues une à une, sans écho ni attente de la touche Entrée.
+ * Les réglages d'origine sont restaurés par restaurerTerminal() à la sortie
+ * du programme, y compris lorsqu'il est interrompu par un signal.
+ */
+void activerModeBrut() {
+    struct termios terminalBrut;
+
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &terminalInitial) != 0) {
+        return;
+    }
+    terminalBrut = terminalInitial;
+    terminalBrut.c_lflag &= ~(ICANON | ECHO);
+    terminalBrut.c_cc[VMIN] = 0;
+    terminalBrut.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalBrut) != 0) {
+        return;
+    }
+    modeBrutActif = true;
+
+    atexit(restaurerTerminal);
+    signal(SIGINT, interrompreProgramme);
+    signal(SIGTERM, interrompreProgramme);
+    signal(SIGHUP, interrompreProgramme);
+    signal(SIGQUIT, interrompreProgramme);
+}
+
+/**
+ * @brief Rend au terminal les réglages qu'il avait au lancement.
+ */
+void restaurerTerminal() {
+    if (modeBrutActif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial);
+        modeBrutActif = false;
+    }
+}
+
+/**
+ * @brief Restaure le terminal puis termine le programme sur un signal.
+ *
+ * Le signal est renvoyé avec son traitement par défaut pour que le programme
+ * se termine comme s'il n'avait pas été intercepté.
+ *
+ * @param numeroSignal Le signal reçu.
+ */
+void interrompreProgramme(int numeroSignal) {
+    restaurerTerminal();
+    signal(numeroSignal, SIG_DFL);
+    raise(numeroSignal);
+}
+
+/**
+ * @brief Lit une touche si l'une d'elles a été appuyée.
+ *
+ * Cette fonction ne bloque pas : poll() vérifie sans attendre si une touche
+ * est disponible sur l'entrée standard, qui reste en mode brut toute la partie.
+ *
+ * @param touche Touche lue.
+ * @return true si une touche a été lue, false sinon.
+ */
+bool lireTouche(char *touche) {
+    struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+    return poll(&entree, 1, 0) > 0 && read(STDIN_FILENO, touche, 1) == 1;
+}
+
+/**
+ * @brief Démarre la cadence des tours à l'instant présent.
+ *
+ * @param cadence Cadence à démarrer.
+ */
+void demarrerCadence(tCadence *cadence) {
+    clock_gettime(CLOCK_MONOTONIC, &cadence->echeance);
+    cadence->nbRetards = 0;
+}
+
+/**
+ * @brief Attend l'échéance du tour suivant.
  *
- * Cette fonction vérifie si une touche a été appuyée sur le clavier.
+ * Les échéances sont absolues : chacune tombe ATTENTE microsecondes après la
+ * précédente, quel que soit le temps passé à calculer et afficher le tour, si
+ * bien que la période reste stable et que les écarts ne s'accumulent pas. Un
+ * tour terminé après son échéance est compté comme un retard et le suivant
+ * commence sans attendre. Au-delà de MAX_TOURS_RETARD tours de retard, la
+ * cadence repart de l'instant présent plutôt que d'enchaîner les tours.
  *
- * @return 1 si une touche a été appuyée, 0 sinon.
+ * @param cadence Cadence du jeu.
+ * @return true si le tour a dépassé son échéance, false sinon.
  */
-int kbhit() {
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-    ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-    if (ch != EOF) {
-        ungetc(ch, stdin);
-        return 1;
+bool attendreTourSuivant(tCadence *cadence) {
+    struct timespec maintenant;
+    long retard;
+
+    cadence->echeance.tv_nsec += ATTENTE * 1000L;
+    cadence->echeance.tv_sec += cadence->echeance.tv_nsec / 1000000000L;
+    cadence->echeance.tv_nsec %= 1000000000L;
+
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    retard = dureeNanosecondes(cadence->echeance, maintenant);
+    if (retard <= 0) {
+        // L'attente reprend jusqu'à la même échéance si un signal l'interrompt
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &cadence->echeance, NULL) == EINTR) {
+        }
+        return false;
+    }
+
+    cadence->nbRetards++;
+    if (retard > MAX_TOURS_RETARD * ATTENTE * 1000L) {
+        cadence->echeance = maintenant;
     }
-    return 0;
-}
\ No newline at end of file
+    return true;
+}